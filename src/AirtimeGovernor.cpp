@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * @file AirtimeGovernor.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "AirtimeGovernor.h"
+#include "TxQueue.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+void AirtimeGovernor::set_budget(uint32_t budget_ms, uint32_t window_ms)
+{
+    // Kept in us, so the budget can be at most about 71 minutes per window
+    this->budget_us = budget_ms > 0xffffffffUL / 1000 ? 0xffffffffUL : budget_ms * 1000;
+    this->bucket_ms = window_ms / NEOMESH_AIRTIME_BUCKETS;
+    if (this->bucket_ms == 0)
+        this->bucket_ms = 1;
+}
+
+void AirtimeGovernor::set_model(uint16_t frame_us, uint16_t byte_us)
+{
+    this->frame_us = frame_us;
+    this->byte_us = byte_us;
+}
+
+void AirtimeGovernor::record(uint32_t now, uint8_t length)
+{
+    this->advance(now);
+    uint32_t airtime = this->estimate(length);
+    this->buckets[this->current] += airtime;
+
+    this->stats.frames++;
+    this->stats.bytes += length;
+    this->stats_us += airtime;
+    this->stats.airtime_ms += this->stats_us / 1000;
+    this->stats_us %= 1000;
+}
+
+bool AirtimeGovernor::allows(uint32_t now, uint8_t length)
+{
+    if (this->budget_us == 0)
+        return true;
+    this->advance(now);
+    return this->used_us() + this->estimate(length) <= this->limit();
+}
+
+uint32_t AirtimeGovernor::time_until_allowed(uint32_t now, uint8_t length)
+{
+    if (this->allows(now, length))
+        return 0;
+
+    uint32_t limit = this->limit();
+    uint32_t needed = this->estimate(length);
+    if (needed > limit)
+        return NEOMESH_NO_DEADLINE;
+
+    // Buckets leave the window oldest first. The oldest is the one after the current
+    uint32_t used = this->used_us();
+    uint32_t left_in_current = this->bucket_ms - (now - this->current_start);
+    for (uint8_t i = 1; i < NEOMESH_AIRTIME_BUCKETS; i++)
+    {
+        used -= this->buckets[(this->current + i) % NEOMESH_AIRTIME_BUCKETS];
+        if (used + needed <= limit)
+            return left_in_current + (uint32_t)(i - 1) * this->bucket_ms;
+    }
+    return left_in_current + (uint32_t)(NEOMESH_AIRTIME_BUCKETS - 1) * this->bucket_ms;
+}
+
+void AirtimeGovernor::held_back()
+{
+    this->stats.held_back++;
+}
+
+uint32_t AirtimeGovernor::get_used(uint32_t now)
+{
+    this->advance(now);
+    return this->used_us() / 1000;
+}
+
+uint32_t AirtimeGovernor::get_budget()
+{
+    return this->budget_us / 1000;
+}
+
+tNcAirtimeStats AirtimeGovernor::get_stats()
+{
+    return this->stats;
+}
+
+/*******************************************************************************
+ *    Private Class/Functions
+ ******************************************************************************/
+
+void AirtimeGovernor::advance(uint32_t now)
+{
+    uint32_t elapsed = now - this->current_start;
+    if (elapsed < this->bucket_ms)
+        return;
+
+    uint32_t steps = elapsed / this->bucket_ms;
+    if (steps >= NEOMESH_AIRTIME_BUCKETS)
+    {
+        memset(this->buckets, 0, sizeof(this->buckets));
+        this->current_start = now;
+        return;
+    }
+    for (uint32_t i = 0; i < steps; i++)
+    {
+        this->current = (this->current + 1) % NEOMESH_AIRTIME_BUCKETS;
+        this->buckets[this->current] = 0;
+    }
+    this->current_start += steps * this->bucket_ms;
+}
+
+uint32_t AirtimeGovernor::estimate(uint8_t length)
+{
+    return this->frame_us + (uint32_t)length * this->byte_us;
+}
+
+uint32_t AirtimeGovernor::limit()
+{
+    return this->budget_us / 100 * (100 - NEOMESH_AIRTIME_RESERVE);
+}
+
+uint32_t AirtimeGovernor::used_us()
+{
+    uint32_t used = 0;
+    for (uint8_t i = 0; i < NEOMESH_AIRTIME_BUCKETS; i++)
+        used += this->buckets[i];
+    return used;
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * @file AirtimeGovernor.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef AIRTIME_GOVERNOR_H
+#define AIRTIME_GOVERNOR_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#ifndef NEOMESH_AIRTIME_WINDOW_MS
+#define NEOMESH_AIRTIME_WINDOW_MS 3600000UL //!< Default length of the sliding window
+#endif
+
+#ifndef NEOMESH_AIRTIME_BUCKETS
+#define NEOMESH_AIRTIME_BUCKETS 12          //!< Slices of the sliding window. More slices free up budget more smoothly
+#endif
+
+#ifndef NEOMESH_AIRTIME_FRAME_US
+#define NEOMESH_AIRTIME_FRAME_US 2000       //!< Estimated airtime of a frame, apart from its bytes
+#endif
+
+#ifndef NEOMESH_AIRTIME_BYTE_US
+#define NEOMESH_AIRTIME_BYTE_US 32          //!< Estimated airtime of each byte written to the module
+#endif
+
+#ifndef NEOMESH_AIRTIME_RESERVE
+#define NEOMESH_AIRTIME_RESERVE 10          //!< Percent of the budget kept free for NEOMESH_PRIORITY_CONTROL frames
+#endif
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief Counters for the airtime governor
+*/
+typedef struct {
+    uint32_t frames;        // Frames counted
+    uint32_t bytes;         // Bytes counted
+    uint32_t airtime_ms;    // Estimated airtime of all counted frames
+    uint32_t held_back;     // Times sending of non-critical frames was stopped because the budget was used
+} tNcAirtimeStats;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Estimates airtime from the frames written to the module, and keeps it within a budget
+* @details Airtime is counted in NEOMESH_AIRTIME_BUCKETS slices of the window, and a slice is
+* forgotten when it has left the window. Each frame is counted as NEOMESH_AIRTIME_FRAME_US plus
+* NEOMESH_AIRTIME_BYTE_US per byte, which can be tuned to the module and radio settings.
+* Non-critical frames are held back when they would use the last NEOMESH_AIRTIME_RESERVE percent
+* of the budget
+*/
+class AirtimeGovernor
+{
+public:
+    /**
+    * @brief Set the budget
+    * @param budget_ms Airtime allowed per window. 0 for no limit
+    * @param window_ms Length of the sliding window
+    */
+    void set_budget(uint32_t budget_ms, uint32_t window_ms);
+
+    /**
+    * @brief Set how airtime is estimated
+    * @param frame_us Airtime of a frame apart from its bytes
+    * @param byte_us Airtime of each byte
+    */
+    void set_model(uint16_t frame_us, uint16_t byte_us);
+
+    /**
+    * @brief Count a frame written to the module
+    * @param now Current millis()
+    * @param length Number of bytes in the frame
+    */
+    void record(uint32_t now, uint8_t length);
+
+    /**
+    * @brief See if a non-critical frame may be sent without using the reserve
+    * @param now Current millis()
+    * @param length Number of bytes in the frame
+    */
+    bool allows(uint32_t now, uint8_t length);
+
+    /**
+    * @brief Get time until enough of the window has passed for a non-critical frame to be allowed
+    * @return Time in ms. NEOMESH_NO_DEADLINE if the frame is larger than the budget
+    */
+    uint32_t time_until_allowed(uint32_t now, uint8_t length);
+
+    /**
+    * @brief Count a stop of non-critical frames
+    */
+    void held_back();
+
+    /**
+    * @brief Get estimated airtime used in the current window. In milliseconds
+    */
+    uint32_t get_used(uint32_t now);
+
+    /**
+    * @brief Get the budget per window. In milliseconds. 0 if there is no limit
+    */
+    uint32_t get_budget();
+
+    /**
+    * @brief Get counters
+    */
+    tNcAirtimeStats get_stats();
+
+private:
+    uint32_t budget_us = 0;
+    uint32_t bucket_ms = NEOMESH_AIRTIME_WINDOW_MS / NEOMESH_AIRTIME_BUCKETS;
+    uint16_t frame_us = NEOMESH_AIRTIME_FRAME_US;
+    uint16_t byte_us = NEOMESH_AIRTIME_BYTE_US;
+
+    uint32_t buckets[NEOMESH_AIRTIME_BUCKETS] = {};   // Airtime in us
+    uint8_t current = 0;
+    uint32_t current_start = 0;     // millis() when the current bucket started
+    uint32_t stats_us = 0;          // Airtime below 1 ms not yet added to stats.airtime_ms
+    tNcAirtimeStats stats = {};
+
+    void advance(uint32_t now);
+    uint32_t estimate(uint8_t length);
+    uint32_t limit();
+    uint32_t used_us();
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // AIRTIME_GOVERNOR_H
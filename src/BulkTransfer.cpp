@@ -0,0 +1,403 @@
+/*******************************************************************************
+ * @file BulkTransfer.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "BulkTransfer.h"
+#include "NeoMesh.h"
+
+#include <string.h>
+
+#include <Arduino.h>
+
+/*******************************************************************************
+ *    Private Defines
+ ******************************************************************************/
+
+#define BULK_OPEN_LENGTH 8
+#define BULK_DONE_LENGTH 3
+#define BULK_MAX_STATUS_BITMAP (NEOMESH_MAX_UNACK_PAYLOAD_LENGTH - NEOMESH_BULK_HEADER_SIZE)
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+BulkTransfer::BulkTransfer(NeoMesh * neo, uint8_t port)
+{
+    this->neo = neo;
+    this->port = port;
+    this->attached = neo->attach_bulk_transfer(this);
+}
+
+bool BulkTransfer::send(uint16_t destNodeId, const uint8_t * data, uint16_t length)
+{
+    if (!this->attached || (this->state != BULK_IDLE && this->state != BULK_FINISHED))
+        return false;
+    uint32_t fragments = ((uint32_t)length + NEOMESH_BULK_FRAGMENT_SIZE - 1) / NEOMESH_BULK_FRAGMENT_SIZE;
+    if (length == 0 || data == nullptr || fragments > NEOMESH_BULK_MAX_FRAGMENTS)
+        return false;
+
+    this->tx_dest = destNodeId;
+    this->tx_data = data;
+    this->tx_length = length;
+    this->tx_fragments = fragments;
+    this->tx_crc = BulkTransfer::crc16(data, length);
+    this->tx_id++;
+    this->tx_confirmed = 0;
+    memset(this->tx_pending, 0, sizeof(this->tx_pending));
+    for (uint16_t i = 0; i < this->tx_fragments; i++)
+        BulkTransfer::set_bit(this->tx_pending, i, true);
+
+    return this->resume();
+}
+
+bool BulkTransfer::resume()
+{
+    if (this->tx_data == nullptr || this->state == BULK_OPENING || this->state == BULK_SENDING || this->state == BULK_POLLING)
+        return false;
+
+    // Start with asking the receiver what it already has
+    this->state = BULK_OPENING;
+    this->tx_retries = 0;
+    this->tx_window = 0;
+    this->tx_cursor = 0;
+    this->send_open();
+    return true;
+}
+
+void BulkTransfer::set_receive_buffer(uint8_t * buffer, uint16_t size)
+{
+    this->rx_buffer = buffer;
+    this->rx_size = size;
+    this->rx_active = false;
+}
+
+uint8_t BulkTransfer::get_port()
+{
+    return this->port;
+}
+
+tNcBulkState BulkTransfer::get_state()
+{
+    return this->state;
+}
+
+uint16_t BulkTransfer::get_confirmed_fragments()
+{
+    return this->tx_confirmed;
+}
+
+uint16_t BulkTransfer::get_fragment_count()
+{
+    return this->tx_fragments;
+}
+
+void BulkTransfer::update()
+{
+    if (this->state == BULK_SENDING)
+    {
+        this->send_fragments();
+    }
+    else if (this->state == BULK_OPENING || this->state == BULK_POLLING)
+    {
+        if (millis() - this->tx_requested_at < NEOMESH_BULK_TIMEOUT_MS)
+            return;
+        if (++this->tx_retries > NEOMESH_BULK_RETRIES)
+            this->finish(BULK_ERR_TIMEOUT);
+        else
+            this->send_open();
+    }
+}
+
+uint32_t BulkTransfer::time_to_next_event()
+{
+    if (this->state == BULK_SENDING)
+        return this->neo->get_tx_queue_count() < NEOMESH_TX_QUEUE_SIZE / 2 ? 0 : NEOMESH_NO_DEADLINE;
+
+    if (this->state == BULK_OPENING || this->state == BULK_POLLING)
+    {
+        uint32_t elapsed = millis() - this->tx_requested_at;
+        return elapsed < NEOMESH_BULK_TIMEOUT_MS ? NEOMESH_BULK_TIMEOUT_MS - elapsed : 0;
+    }
+    return NEOMESH_NO_DEADLINE;
+}
+
+void BulkTransfer::frame_received(uint16_t originId, uint8_t * payload, uint8_t payloadLength)
+{
+    if (payloadLength < 2)
+        return;
+
+    switch (payload[0])
+    {
+        case BulkOpen:
+            this->open_received(originId, payload, payloadLength);
+            break;
+        case BulkData:
+            this->data_received(originId, payload, payloadLength);
+            break;
+        case BulkStatus:
+            if (originId == this->tx_dest)
+                this->status_received(payload, payloadLength);
+            break;
+        case BulkDone:
+            if (originId == this->tx_dest && payload[1] == this->tx_id && payloadLength >= BULK_DONE_LENGTH
+                && this->state != BULK_IDLE && this->state != BULK_FINISHED)
+            {
+                if (payload[2] == BULK_OK)
+                    this->tx_confirmed = this->tx_fragments;
+                this->finish((tNcBulkResult)payload[2]);
+            }
+            break;
+    }
+}
+
+uint16_t BulkTransfer::crc16(const uint8_t * data, uint16_t length)
+{
+    // CRC-16/CCITT-FALSE
+    uint16_t crc = 0xffff;
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+/*******************************************************************************
+ *    Private Class/Functions
+ ******************************************************************************/
+
+bool BulkTransfer::send_open()
+{
+    uint8_t frame[BULK_OPEN_LENGTH] = {
+        BulkOpen,
+        this->tx_id,
+        (uint8_t)(this->tx_length >> 8),
+        (uint8_t)this->tx_length,
+        (uint8_t)(this->tx_fragments >> 8),
+        (uint8_t)this->tx_fragments,
+        (uint8_t)(this->tx_crc >> 8),
+        (uint8_t)this->tx_crc
+    };
+    this->tx_requested_at = millis();
+    return this->neo->send_unacknowledged(this->tx_dest, this->port, frame, BULK_OPEN_LENGTH) == NCAPI_OK;
+}
+
+void BulkTransfer::send_fragments()
+{
+    while (this->tx_window < NEOMESH_BULK_WINDOW)
+    {
+        // Leave room in the transmit queue for other traffic
+        if (this->neo->get_tx_queue_count() >= NEOMESH_TX_QUEUE_SIZE / 2)
+            return;
+
+        uint16_t i = this->tx_cursor;
+        while (i < this->tx_fragments && !BulkTransfer::get_bit(this->tx_pending, i))
+            i++;
+        if (i >= this->tx_fragments)
+            break;
+
+        uint16_t offset = i * NEOMESH_BULK_FRAGMENT_SIZE;
+        uint8_t length = this->tx_length - offset < NEOMESH_BULK_FRAGMENT_SIZE ? this->tx_length - offset : NEOMESH_BULK_FRAGMENT_SIZE;
+        uint8_t frame[NEOMESH_MAX_UNACK_PAYLOAD_LENGTH];
+        frame[0] = BulkData;
+        frame[1] = this->tx_id;
+        frame[2] = i >> 8;
+        frame[3] = i;
+        memcpy(frame + NEOMESH_BULK_HEADER_SIZE, this->tx_data + offset, length);
+        if (this->neo->send_unacknowledged(this->tx_dest, this->port, frame, NEOMESH_BULK_HEADER_SIZE + length, nullptr, NEOMESH_PRIORITY_BULK) != NCAPI_OK)
+            return;
+
+        BulkTransfer::set_bit(this->tx_pending, i, false);
+        this->tx_cursor = i + 1;
+        this->tx_window++;
+    }
+
+    // Window is full or nothing more to send. Ask which fragments are missing
+    this->state = BULK_POLLING;
+    this->tx_window = 0;
+    this->tx_retries = 0;
+    this->send_open();
+}
+
+void BulkTransfer::finish(tNcBulkResult result)
+{
+    this->state = BULK_FINISHED;
+    if (this->sent_callback != 0)
+        this->sent_callback(result);
+}
+
+void BulkTransfer::status_received(uint8_t * payload, uint8_t payloadLength)
+{
+    if (payload[1] != this->tx_id || payloadLength < NEOMESH_BULK_HEADER_SIZE
+        || (this->state != BULK_OPENING && this->state != BULK_POLLING))
+        return;
+
+    uint16_t base = (payload[2] << 8) | payload[3];
+    uint8_t *bitmap = payload + NEOMESH_BULK_HEADER_SIZE;
+    uint16_t covered = (payloadLength - NEOMESH_BULK_HEADER_SIZE) * 8;
+    if (base > this->tx_fragments)
+        return;
+
+    // Everything below base has arrived. Inside the bitmap only the gaps are sent again.
+    // Fragments after the bitmap keep their state until a later status covers them
+    uint16_t confirmed = base;
+    for (uint16_t i = 0; i < this->tx_fragments; i++)
+    {
+        if (i < base)
+        {
+            BulkTransfer::set_bit(this->tx_pending, i, false);
+        }
+        else if (i - base < covered)
+        {
+            bool missing = BulkTransfer::get_bit(bitmap, i - base);
+            BulkTransfer::set_bit(this->tx_pending, i, missing);
+            if (!missing)
+                confirmed++;
+        }
+    }
+    this->tx_confirmed = confirmed;
+    this->tx_cursor = base;
+    this->tx_window = 0;
+    this->state = BULK_SENDING;
+    this->send_fragments();
+}
+
+void BulkTransfer::open_received(uint16_t originId, uint8_t * payload, uint8_t payloadLength)
+{
+    if (payloadLength < BULK_OPEN_LENGTH)
+        return;
+
+    uint8_t id = payload[1];
+    uint16_t length = (payload[2] << 8) | payload[3];
+    uint16_t fragments = (payload[4] << 8) | payload[5];
+    uint16_t crc = (payload[6] << 8) | payload[7];
+
+    bool same = this->rx_active && originId == this->rx_origin && id == this->rx_id
+        && length == this->rx_length && crc == this->rx_crc;
+    if (!same)
+    {
+        // New transfer. Anything received for an earlier one is discarded
+        this->rx_origin = originId;
+        this->rx_id = id;
+        this->rx_length = length;
+        this->rx_fragments = fragments;
+        this->rx_crc = crc;
+        this->rx_complete = false;
+        memset(this->rx_received, 0, sizeof(this->rx_received));
+
+        uint32_t expected = ((uint32_t)length + NEOMESH_BULK_FRAGMENT_SIZE - 1) / NEOMESH_BULK_FRAGMENT_SIZE;
+        this->rx_active = this->rx_buffer != nullptr && length <= this->rx_size
+            && fragments == expected && fragments <= NEOMESH_BULK_MAX_FRAGMENTS;
+        if (!this->rx_active)
+        {
+            this->send_done(BULK_ERR_TOO_LARGE);
+            return;
+        }
+    }
+
+    if (this->rx_complete)
+        this->send_done(BULK_OK);   // Sender missed our done
+    else
+        this->send_status();
+}
+
+void BulkTransfer::data_received(uint16_t originId, uint8_t * payload, uint8_t payloadLength)
+{
+    if (!this->rx_active || this->rx_complete || originId != this->rx_origin || payload[1] != this->rx_id
+        || payloadLength < NEOMESH_BULK_HEADER_SIZE)
+        return;
+
+    uint16_t i = (payload[2] << 8) | payload[3];
+    if (i >= this->rx_fragments)
+        return;
+
+    uint16_t offset = i * NEOMESH_BULK_FRAGMENT_SIZE;
+    uint8_t length = payloadLength - NEOMESH_BULK_HEADER_SIZE;
+    uint8_t expected = this->rx_length - offset < NEOMESH_BULK_FRAGMENT_SIZE ? this->rx_length - offset : NEOMESH_BULK_FRAGMENT_SIZE;
+    if (length != expected)
+        return;
+
+    memcpy(this->rx_buffer + offset, payload + NEOMESH_BULK_HEADER_SIZE, length);
+    BulkTransfer::set_bit(this->rx_received, i, true);
+
+    for (uint16_t j = 0; j < this->rx_fragments; j++)
+    {
+        if (!BulkTransfer::get_bit(this->rx_received, j))
+            return;
+    }
+
+    if (BulkTransfer::crc16(this->rx_buffer, this->rx_length) != this->rx_crc)
+    {
+        // Start over. The sender will see everything as missing on its next request
+        memset(this->rx_received, 0, sizeof(this->rx_received));
+        this->send_done(BULK_ERR_CHECKSUM);
+        this->rx_active = false;
+        return;
+    }
+
+    this->rx_complete = true;
+    this->send_done(BULK_OK);
+    if (this->received_callback != 0)
+        this->received_callback(this->rx_origin, this->rx_buffer, this->rx_length);
+}
+
+void BulkTransfer::send_status()
+{
+    uint16_t base = 0;
+    while (base < this->rx_fragments && BulkTransfer::get_bit(this->rx_received, base))
+        base++;
+
+    uint16_t remaining = this->rx_fragments - base;
+    uint8_t bitmap_length = (remaining + 7) / 8 < BULK_MAX_STATUS_BITMAP ? (remaining + 7) / 8 : BULK_MAX_STATUS_BITMAP;
+
+    uint8_t frame[NEOMESH_MAX_UNACK_PAYLOAD_LENGTH];
+    frame[0] = BulkStatus;
+    frame[1] = this->rx_id;
+    frame[2] = base >> 8;
+    frame[3] = base;
+    memset(frame + NEOMESH_BULK_HEADER_SIZE, 0, bitmap_length);
+    for (uint16_t i = 0; i < bitmap_length * 8 && base + i < this->rx_fragments; i++)
+    {
+        if (!BulkTransfer::get_bit(this->rx_received, base + i))
+            BulkTransfer::set_bit(frame + NEOMESH_BULK_HEADER_SIZE, i, true);
+    }
+    this->neo->send_unacknowledged(this->rx_origin, this->port, frame, NEOMESH_BULK_HEADER_SIZE + bitmap_length);
+}
+
+void BulkTransfer::send_done(tNcBulkResult result)
+{
+    uint8_t frame[BULK_DONE_LENGTH] = { BulkDone, this->rx_id, (uint8_t)result };
+    this->neo->send_unacknowledged(this->rx_origin, this->port, frame, BULK_DONE_LENGTH);
+}
+
+bool BulkTransfer::get_bit(const uint8_t * bitmap, uint16_t i)
+{
+    return (bitmap[i / 8] >> (i % 8)) & 1;
+}
+
+void BulkTransfer::set_bit(uint8_t * bitmap, uint16_t i, bool value)
+{
+    if (value)
+        bitmap[i / 8] |= 1 << (i % 8);
+    else
+        bitmap[i / 8] &= ~(1 << (i % 8));
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
@@ -0,0 +1,242 @@
+/*******************************************************************************
+ * @file BulkTransfer.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef BULK_TRANSFER_H
+#define BULK_TRANSFER_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NcApi.h"
+#include "TxQueue.h"
+#include "Delegate.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#ifndef NEOMESH_BULK_PORT
+#define NEOMESH_BULK_PORT 3             //!< Port reserved for bulk transfers
+#endif
+
+#ifndef NEOMESH_BULK_MAX_FRAGMENTS
+#define NEOMESH_BULK_MAX_FRAGMENTS 256  //!< Largest transfer in fragments. Each fragment carries NEOMESH_BULK_FRAGMENT_SIZE bytes
+#endif
+
+#ifndef NEOMESH_BULK_WINDOW
+#define NEOMESH_BULK_WINDOW 16          //!< Fragments sent before the receiver is asked which are missing
+#endif
+
+#ifndef NEOMESH_BULK_TIMEOUT_MS
+#define NEOMESH_BULK_TIMEOUT_MS 5000    //!< Time to wait for the receiver to answer
+#endif
+
+#ifndef NEOMESH_BULK_RETRIES
+#define NEOMESH_BULK_RETRIES 5          //!< Unanswered requests before the transfer fails
+#endif
+
+#define NEOMESH_BULK_HEADER_SIZE 4
+#define NEOMESH_BULK_FRAGMENT_SIZE (NEOMESH_MAX_UNACK_PAYLOAD_LENGTH - NEOMESH_BULK_HEADER_SIZE)
+#define NEOMESH_BULK_BITMAP_SIZE ((NEOMESH_BULK_MAX_FRAGMENTS + 7) / 8)
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief Frame kinds used by the bulk transfer protocol. Always the first payload byte
+*/
+typedef enum {
+    BulkOpen   = 1, // Sender -> receiver: id, total length, fragment count, CRC. Also asks for status
+    BulkData   = 2, // Sender -> receiver: id, fragment index, fragment data
+    BulkStatus = 3, // Receiver -> sender: id, base index, bitmap of missing fragments from base
+    BulkDone   = 4  // Receiver -> sender: id, tNcBulkResult
+} tNcBulkFrameKind;
+
+/**
+* @brief Outcome of a bulk transfer
+*/
+typedef enum {
+    BULK_OK = 0,
+    BULK_ERR_CHECKSUM = 1,  // All fragments arrived but the checksum did not match
+    BULK_ERR_TOO_LARGE = 2, // The receiver has no room for the transfer
+    BULK_ERR_TIMEOUT = 3    // The receiver did not answer
+} tNcBulkResult;
+
+typedef enum {
+    BULK_IDLE,
+    BULK_OPENING,   // Waiting for first status
+    BULK_SENDING,   // Sending missing fragments
+    BULK_POLLING,   // Window sent. Waiting for status
+    BULK_FINISHED
+} tNcBulkState;
+
+/**
+ * \brief Application provided function called when an outgoing transfer has finished
+ * @param result BULK_OK if the receiver got all data with a matching checksum
+ */
+typedef Delegate<void(tNcBulkResult result)> NeoMeshBulkSentCallback;
+
+/**
+ * \brief Application provided function called when an incoming transfer is complete
+ * @param originId The sender
+ * @param data The receive buffer
+ * @param length Number of bytes received
+ */
+typedef Delegate<void(uint16_t originId, uint8_t * data, uint16_t length)> NeoMeshBulkReceivedCallback;
+
+class NeoMesh;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Moves buffers larger than one frame over unacknowledged frames
+* @details The buffer is split into fragments of NEOMESH_BULK_FRAGMENT_SIZE bytes which are sent
+* NEOMESH_BULK_WINDOW at a time without waiting for each to be acknowledged. After each window
+* the receiver answers with a bitmap of missing fragments, and only those are sent again.
+* The receiver checks a CRC over the whole buffer. A transfer that has failed can be resumed,
+* as the receiver keeps what it got. All frames use the port given to the constructor,
+* which should be reserved for this on both nodes
+*/
+class BulkTransfer
+{
+public:
+    /**
+    * @brief Construct a bulk transfer endpoint and attach it to a NeoMesh object
+    * @details Only one endpoint can be attached to a NeoMesh object. Further endpoints are not
+    * attached, and can neither send nor receive
+    * @param neo The NeoMesh object to send and receive through
+    * @param port The reserved port
+    */
+    BulkTransfer(NeoMesh * neo, uint8_t port = NEOMESH_BULK_PORT);
+
+    /**
+    * @brief Start sending a buffer
+    * @param destNodeId The receiver
+    * @param data The data. Must stay valid until sent_callback is called
+    * @param length Number of bytes. At most NEOMESH_BULK_MAX_FRAGMENTS * NEOMESH_BULK_FRAGMENT_SIZE
+    * @return True if the transfer was started. False if one is already running, the buffer is too large, or the endpoint is not attached
+    */
+    bool send(uint16_t destNodeId, const uint8_t * data, uint16_t length);
+
+    /**
+    * @brief Continue the last transfer after it failed
+    * @details The receiver is asked what it is missing, so fragments already received are not sent again
+    * @return True if there is a transfer to resume
+    */
+    bool resume();
+
+    /**
+    * @brief Give the receiving side a buffer to put incoming transfers in
+    * @param buffer The buffer
+    * @param size Size of the buffer in bytes
+    */
+    void set_receive_buffer(uint8_t * buffer, uint16_t size);
+
+    /**
+    * @brief Get the port used for bulk frames
+    */
+    uint8_t get_port();
+
+    /**
+    * @brief Get state of the outgoing transfer
+    */
+    tNcBulkState get_state();
+
+    /**
+    * @brief Get number of fragments the receiver has confirmed
+    */
+    uint16_t get_confirmed_fragments();
+
+    /**
+    * @brief Get number of fragments in the outgoing transfer
+    */
+    uint16_t get_fragment_count();
+
+    /**
+    * @brief Handles timeouts and sending. Called by NeoMesh::update()
+    */
+    void update();
+
+    /**
+    * @brief Get time until update() has something to do
+    * @return Time in ms. NEOMESH_NO_DEADLINE if it only waits for frames from the receiver or room in the transmit queue
+    */
+    uint32_t time_to_next_event();
+
+    /**
+    * @brief Handle an unacknowledged frame received on the reserved port. Called by NeoMesh
+    */
+    void frame_received(uint16_t originId, uint8_t * payload, uint8_t payloadLength);
+
+    /**
+    * @brief Calculate CRC-16/CCITT over a buffer
+    */
+    static uint16_t crc16(const uint8_t * data, uint16_t length);
+
+    NeoMeshBulkSentCallback sent_callback = 0;
+    NeoMeshBulkReceivedCallback received_callback = 0;
+
+private:
+    NeoMesh * neo;
+    uint8_t port;
+    bool attached;
+
+    // Outgoing
+    tNcBulkState state = BULK_IDLE;
+    uint16_t tx_dest = 0;
+    const uint8_t * tx_data = nullptr;
+    uint16_t tx_length = 0;
+    uint16_t tx_fragments = 0;
+    uint16_t tx_crc = 0;
+    uint8_t tx_id = 0;
+    uint16_t tx_confirmed = 0;
+    uint8_t tx_pending[NEOMESH_BULK_BITMAP_SIZE];   // Fragments that must be sent (again)
+    uint16_t tx_cursor = 0;
+    uint8_t tx_window = 0;
+    uint8_t tx_retries = 0;
+    uint32_t tx_requested_at = 0;
+
+    // Incoming
+    uint8_t * rx_buffer = nullptr;
+    uint16_t rx_size = 0;
+    uint16_t rx_origin = 0;
+    uint8_t rx_id = 0;
+    uint16_t rx_length = 0;
+    uint16_t rx_fragments = 0;
+    uint16_t rx_crc = 0;
+    bool rx_active = false;
+    bool rx_complete = false;
+    uint8_t rx_received[NEOMESH_BULK_BITMAP_SIZE];
+
+    bool send_open();
+    void send_fragments();
+    void finish(tNcBulkResult result);
+    void status_received(uint8_t * payload, uint8_t payloadLength);
+    void open_received(uint16_t originId, uint8_t * payload, uint8_t payloadLength);
+    void data_received(uint16_t originId, uint8_t * payload, uint8_t payloadLength);
+    void send_status();
+    void send_done(tNcBulkResult result);
+
+    static bool get_bit(const uint8_t * bitmap, uint16_t i);
+    static void set_bit(uint8_t * bitmap, uint16_t i, bool value);
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // BULK_TRANSFER_H
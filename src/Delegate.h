@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * @file Delegate.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef DELEGATE_H
+#define DELEGATE_H
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+
+template <typename SIGNATURE> class Delegate;
+
+/**
+* @brief A callback that can carry its own context
+* @details Holds either a plain function, a member function bound to an object, or a
+* function that takes a context pointer as its first argument. The delegate is a fixed size
+* and never allocates. A plain function converts to a delegate, so existing callbacks can
+* still be assigned directly:
+*
+*     neo.host_data_callback = host_data;
+*     neo.host_data_callback = NeoMeshHostDataCallback::from_method<Gateway, &Gateway::host_data>(&gateway);
+*     neo.host_data_callback = NeoMeshHostDataCallback(log_host_data, &log);
+*/
+template <typename R, typename... ARGS>
+class Delegate<R(ARGS...)>
+{
+public:
+    typedef R (*Function)(ARGS...);
+    typedef R (*ContextFunction)(void *context, ARGS...);
+
+    Delegate() : stub(nullptr) {}
+
+    Delegate(Function function) : stub(function != nullptr ? &Delegate::function_stub : nullptr)
+    {
+        this->target.function = function;
+    }
+
+    Delegate(ContextFunction function, void *context) : stub(function != nullptr ? &Delegate::context_stub : nullptr)
+    {
+        this->target.with_context.function = function;
+        this->target.with_context.context = context;
+    }
+
+    /**
+    * @brief Create a delegate that calls METHOD on object
+    */
+    template <typename T, R (T::*METHOD)(ARGS...)>
+    static Delegate from_method(T *object)
+    {
+        Delegate d;
+        d.target.object = object;
+        d.stub = &Delegate::method_stub<T, METHOD>;
+        return d;
+    }
+
+    R operator()(ARGS... args) const
+    {
+        return this->stub(this->target, args...);
+    }
+
+    bool operator==(decltype(nullptr)) const { return this->stub == nullptr; }
+    bool operator!=(decltype(nullptr)) const { return this->stub != nullptr; }
+
+private:
+    union Target {
+        void *object;
+        Function function;
+        struct {
+            ContextFunction function;
+            void *context;
+        } with_context;
+    };
+
+    Target target;
+    R (*stub)(const Target &target, ARGS... args);
+
+    static R function_stub(const Target &target, ARGS... args)
+    {
+        return target.function(args...);
+    }
+
+    static R context_stub(const Target &target, ARGS... args)
+    {
+        return target.with_context.function(target.with_context.context, args...);
+    }
+
+    template <typename T, R (T::*METHOD)(ARGS...)>
+    static R method_stub(const Target &target, ARGS... args)
+    {
+        return (static_cast<T *>(target.object)->*METHOD)(args...);
+    }
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // DELEGATE_H
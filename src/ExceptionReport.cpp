@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * @file ExceptionReport.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "ExceptionReport.h"
+
+#include <Arduino.h>
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+ExceptionReporter::ExceptionReporter(NeoMesh * neo, uint16_t destNodeId)
+{
+    this->neo = neo;
+    this->dest = destNodeId;
+}
+
+bool ExceptionReporter::configure(uint8_t port, uint8_t channel, uint32_t deadband, uint32_t max_silence_ms)
+{
+    tNcReportChannel * c = this->find(port, channel);
+    if (c == nullptr)
+    {
+        for (int i = 0; i < NEOMESH_REPORT_CHANNELS && c == nullptr; i++)
+        {
+            if (!this->channels[i].used)
+                c = &this->channels[i];
+        }
+        if (c == nullptr)
+            return false;
+        *c = {};
+        c->used = true;
+        c->port = port;
+        c->channel = channel;
+    }
+    c->deadband = deadband;
+    c->max_silence_ms = max_silence_ms;
+    return true;
+}
+
+bool ExceptionReporter::sample(uint8_t port, uint8_t channel, int32_t value)
+{
+    tNcReportChannel * c = this->find(port, channel);
+    if (c == nullptr)
+        return false;
+    this->stats.samples++;
+
+    if (c->pending && !this->send(c, ReportChange))
+    {
+        // The earlier sample is still not queued and is replaced by this one
+        this->stats.dropped++;
+        c->suppressed++;
+        c->gap = true;
+        c->latest_value = value;
+        return false;
+    }
+
+    // Difference taken in 64 bits, so values far apart do not wrap into the deadband
+    int64_t diff = (int64_t)value - c->reported_value;
+    if (diff < 0)
+        diff = -diff;
+    if (c->reported && diff <= c->deadband)
+    {
+        c->latest_value = value;
+        c->suppressed++;
+        return false;
+    }
+
+    c->latest_value = value;
+    return this->send(c, ReportChange);
+}
+
+uint32_t ExceptionReporter::update()
+{
+    uint32_t now = millis();
+    uint32_t next = NEOMESH_NO_DEADLINE;
+    for (int i = 0; i < NEOMESH_REPORT_CHANNELS; i++)
+    {
+        tNcReportChannel * c = &this->channels[i];
+        if (!c->used)
+            continue;
+
+        if (c->pending)
+        {
+            this->send(c, ReportChange);
+            continue;   // If the queue is still full, CTS makes room and wakes the MCU
+        }
+
+        if (!c->reported || c->max_silence_ms == 0)
+            continue;
+        uint32_t silent = now - c->reported_at;
+        if (silent >= c->max_silence_ms)
+        {
+            this->send(c, ReportHeartbeat);
+            silent = 0;
+        }
+        uint32_t left = c->max_silence_ms - silent;
+        if (left < next)
+            next = left;
+    }
+    return next;
+}
+
+tNcReporterStats ExceptionReporter::get_stats()
+{
+    return this->stats;
+}
+
+ExceptionReceiver::ExceptionReceiver(NeoMesh * neo, uint8_t port)
+{
+    neo->register_port_handler(NEOMESH_ALL_HOST_DATA, port,
+        NeoMeshPortHandler::from_method<ExceptionReceiver, &ExceptionReceiver::frame_received>(this));
+}
+
+void ExceptionReceiver::frame_received(tNcHostDataMessage * m)
+{
+    if (m->payloadLength < NEOMESH_REPORT_LENGTH)
+        return;
+
+    const uint8_t * p = m->payload;
+    tNcExceptionReport report;
+    report.originId = m->originId;
+    report.port = m->port;
+    report.channel = p[0];
+    report.heartbeat = (p[2] & ~NEOMESH_REPORT_FLAG_GAP) == ReportHeartbeat;
+    report.value = (int32_t)((uint32_t)p[3] << 24 | (uint32_t)p[4] << 16 | (uint32_t)p[5] << 8 | p[6]);
+    report.held_samples = (uint16_t)p[7] << 8 | p[8];
+    report.packageAge = m->packageAge;
+
+    tNcReportSeries * s = this->find(m->originId, m->port, report.channel);
+    if (s == nullptr)
+        return;
+
+    if (s->originId == 0)
+    {
+        // First report of this series. What came before is not known
+        s->originId = m->originId;
+        s->port = m->port;
+        s->channel = report.channel;
+        report.gap = true;
+        report.held_value = report.value;
+    }
+    else
+    {
+        uint8_t missing = p[1] - s->seq - 1;
+        report.gap = missing != 0 || (p[2] & NEOMESH_REPORT_FLAG_GAP) != 0;
+        this->lost += missing;
+        report.held_value = s->value;
+    }
+    s->seq = p[1];
+    s->value = report.value;
+
+    if (this->report_callback != 0)
+        this->report_callback(&report);
+}
+
+uint32_t ExceptionReceiver::get_lost_count()
+{
+    return this->lost;
+}
+
+/*******************************************************************************
+ *    Private Class/Functions
+ ******************************************************************************/
+
+tNcReportChannel * ExceptionReporter::find(uint8_t port, uint8_t channel)
+{
+    for (int i = 0; i < NEOMESH_REPORT_CHANNELS; i++)
+    {
+        if (this->channels[i].used && this->channels[i].port == port && this->channels[i].channel == channel)
+            return &this->channels[i];
+    }
+    return nullptr;
+}
+
+bool ExceptionReporter::send(tNcReportChannel * c, tNcReportKind kind)
+{
+    int32_t value = c->latest_value;
+    uint8_t payload[NEOMESH_REPORT_LENGTH] = {
+        c->channel,
+        c->seq,
+        (uint8_t)(c->gap ? kind | NEOMESH_REPORT_FLAG_GAP : kind),
+        (uint8_t)((uint32_t)value >> 24),
+        (uint8_t)((uint32_t)value >> 16),
+        (uint8_t)((uint32_t)value >> 8),
+        (uint8_t)value,
+        (uint8_t)(c->suppressed >> 8),
+        (uint8_t)c->suppressed
+    };
+
+    if (this->neo->send_unacknowledged(this->dest, c->port, payload, NEOMESH_REPORT_LENGTH) != NCAPI_OK)
+    {
+        this->stats.failed++;
+        c->pending = kind == ReportChange;
+        if (kind == ReportHeartbeat)
+            c->reported_at = millis();  // Try again after another interval rather than on every update
+        return false;
+    }
+
+    if (kind == ReportChange)
+        this->stats.reports++;
+    else
+        this->stats.heartbeats++;
+    c->seq++;
+    c->reported = true;
+    c->pending = false;
+    c->gap = false;
+    c->reported_value = value;
+    c->suppressed = 0;
+    c->reported_at = millis();
+    return true;
+}
+
+tNcReportSeries * ExceptionReceiver::find(uint16_t originId, uint8_t port, uint8_t channel)
+{
+    tNcReportSeries * free_series = nullptr;
+    for (int i = 0; i < NEOMESH_REPORT_SERIES; i++)
+    {
+        tNcReportSeries * s = &this->series[i];
+        if (s->originId == originId && s->port == port && s->channel == channel)
+            return s;
+        if (s->originId == 0 && free_series == nullptr)
+            free_series = s;
+    }
+    return free_series;
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
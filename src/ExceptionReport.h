@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * @file ExceptionReport.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef EXCEPTION_REPORT_H
+#define EXCEPTION_REPORT_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NeoMesh.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#ifndef NEOMESH_REPORT_CHANNELS
+#define NEOMESH_REPORT_CHANNELS 8   //!< Number of (port, channel) pairs an ExceptionReporter can report
+#endif
+
+#ifndef NEOMESH_REPORT_SERIES
+#define NEOMESH_REPORT_SERIES 16    //!< Number of (node, port, channel) series an ExceptionReceiver can follow
+#endif
+
+#define NEOMESH_REPORT_LENGTH 9
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief Kind of report. Third payload byte
+*/
+typedef enum {
+    ReportChange    = 0,    // The sample left the deadband
+    ReportHeartbeat = 1     // The maximum silence interval expired
+} tNcReportKind;
+
+#define NEOMESH_REPORT_FLAG_GAP 0x80    //!< Set in the kind byte when the reporter dropped a sample it could not queue
+
+/**
+* @brief A report as reconstructed by ExceptionReceiver
+* @details The samples that were not reported all lay within the deadband of held_value, so
+* the series up to this report is held_value repeated held_samples times. For a change report
+* it continues with value. For a heartbeat, value is the last of the held samples
+*/
+typedef struct {
+    uint16_t originId;
+    uint8_t port;
+    uint8_t channel;
+    bool heartbeat;
+    bool gap;               // True if reports were lost since the previous one, or the reporter dropped a sample. held_value is then not known
+    int32_t held_value;     // Value reported before this one
+    uint16_t held_samples;  // Samples not reported since the previous report, including the ones the reporter dropped
+    int32_t value;
+    uint32_t packageAge;
+} tNcExceptionReport;
+
+/**
+* @brief Counters for an ExceptionReporter
+*/
+typedef struct {
+    uint32_t samples;       // Samples passed to sample()
+    uint32_t reports;       // Change reports sent
+    uint32_t heartbeats;    // Heartbeats sent
+    uint32_t failed;        // Reports that could not be queued. Sent again from update()
+    uint32_t dropped;       // Samples replaced by a newer one before their change report could be queued
+} tNcReporterStats;
+
+/**
+ * \brief Application provided function called by ExceptionReceiver for every report
+ * @param report The report
+ */
+typedef Delegate<void(const tNcExceptionReport * report)> NeoMeshReportCallback;
+
+typedef struct {
+    bool used;
+    uint8_t port;
+    uint8_t channel;
+    uint32_t deadband;
+    uint32_t max_silence_ms;
+    bool reported;          // True once the first report has been sent
+    bool pending;           // True if the last change report could not be queued
+    bool gap;               // True if a sample was dropped since the last report
+    int32_t reported_value; // Last value sent
+    int32_t latest_value;   // Last sample
+    uint16_t suppressed;    // Samples since the last report
+    uint32_t reported_at;   // millis() of the last report
+    uint8_t seq;
+} tNcReportChannel;
+
+typedef struct {
+    uint16_t originId;      // 0 if unused
+    uint8_t port;
+    uint8_t channel;
+    uint8_t seq;            // Sequence number of the last report
+    int32_t value;          // Value held since the last report
+} tNcReportSeries;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Sends samples of a (port, channel) only when they change
+* @details A sample is sent when it differs from the last sent value by more than the deadband.
+* When nothing has been sent for the maximum silence interval, a heartbeat with the latest sample
+* is sent, so the receiver knows the node is alive. Each report carries the number of samples
+* left out before it, so ExceptionReceiver can rebuild the full series
+*/
+class ExceptionReporter
+{
+public:
+    /**
+    * @brief Construct a reporter
+    * @param neo The NeoMesh object to send through
+    * @param destNodeId The node running the ExceptionReceiver
+    */
+    ExceptionReporter(NeoMesh * neo, uint16_t destNodeId);
+
+    /**
+    * @brief Set up a (port, channel) pair
+    * @param port The port to send the reports to
+    * @param channel Identifies the series within the port
+    * @param deadband Largest difference from the last sent value that is not reported
+    * @param max_silence_ms Longest time without a report. 0 for no heartbeats
+    * @return False if all NEOMESH_REPORT_CHANNELS are in use
+    */
+    bool configure(uint8_t port, uint8_t channel, uint32_t deadband, uint32_t max_silence_ms);
+
+    /**
+    * @brief Pass a new sample
+    * @param port The port given to configure
+    * @param channel The channel given to configure
+    * @param value The sample
+    * @details If the previous change report could still not be queued, that sample is dropped. It is
+    * counted in the held samples of the next report, which is flagged as a gap
+    * @return True if the sample was sent. False if it was within the deadband, could not be queued, or the pair is not configured
+    */
+    bool sample(uint8_t port, uint8_t channel, int32_t value);
+
+    /**
+    * @brief Sends heartbeats and reports that could not be queued before. Call from main loop
+    * @return Time in ms until the next heartbeat. NEOMESH_NO_DEADLINE if there is none
+    */
+    uint32_t update();
+
+    /**
+    * @brief Get counters
+    */
+    tNcReporterStats get_stats();
+
+private:
+    NeoMesh * neo;
+    uint16_t dest;
+    tNcReportChannel channels[NEOMESH_REPORT_CHANNELS] = {};
+    tNcReporterStats stats = {};
+
+    tNcReportChannel * find(uint8_t port, uint8_t channel);
+    bool send(tNcReportChannel * c, tNcReportKind kind);
+};
+
+/**
+* @brief Rebuilds the series sent by ExceptionReporter on other nodes
+*/
+class ExceptionReceiver
+{
+public:
+    /**
+    * @brief Construct a receiver and register it as handler for host data on a port
+    * @param neo The NeoMesh object to receive through
+    * @param port The port the reporters send to
+    */
+    ExceptionReceiver(NeoMesh * neo, uint8_t port);
+
+    /**
+    * @brief Handle host data on the port. Called through the port handler
+    */
+    void frame_received(tNcHostDataMessage * m);
+
+    /**
+    * @brief Get number of reports that were lost, seen as gaps in the sequence numbers
+    */
+    uint32_t get_lost_count();
+
+    NeoMeshReportCallback report_callback = 0;
+
+private:
+    tNcReportSeries series[NEOMESH_REPORT_SERIES] = {};
+    uint32_t lost = 0;
+
+    tNcReportSeries * find(uint16_t originId, uint8_t port, uint8_t channel);
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // EXCEPTION_REPORT_H
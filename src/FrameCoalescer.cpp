@@ -0,0 +1,219 @@
+/*******************************************************************************
+ * @file FrameCoalescer.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "FrameCoalescer.h"
+
+#include <string.h>
+
+#include <Arduino.h>
+
+/*******************************************************************************
+ *    Private Defines
+ ******************************************************************************/
+
+#define COALESCE_PORT(header) ((header) >> 5)
+#define COALESCE_LENGTH(header) ((header) & 0x1f)
+#define COALESCE_HEADER(port, length) (uint8_t)((port) << 5 | (length))
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+FrameCoalescer::FrameCoalescer(NeoMesh * neo, uint8_t port, bool acknowledged)
+{
+    this->neo = neo;
+    this->port = port;
+    this->acknowledged = acknowledged;
+    this->max_length = acknowledged ? NCAPI_MAX_PAYLOAD_LENGTH : NEOMESH_MAX_UNACK_PAYLOAD_LENGTH;
+    neo->register_port_handler(NEOMESH_ALL_HOST_DATA, port,
+        NeoMeshPortHandler::from_method<FrameCoalescer, &FrameCoalescer::frame_received>(this));
+}
+
+bool FrameCoalescer::send(uint16_t destNodeId, uint8_t port, const uint8_t * payload, uint8_t payloadLen)
+{
+    if (port >= NEOMESH_PORT_COUNT || port == this->port || destNodeId == 0 || (payloadLen != 0 && payload == nullptr))
+        return false;
+    this->stats.messages++;
+
+    // Messages already waiting for the destination go first, so its messages stay in order
+    if (payloadLen > this->get_max_message())
+        return this->flush(destNodeId) && this->send_direct(destNodeId, port, (uint8_t *) payload, payloadLen);
+
+    tNcCoalesceFrame * frame = this->get_frame(destNodeId);
+    if (frame == nullptr)
+        return false;
+    if (frame->length + 1 + payloadLen > this->max_length && !this->send_frame(frame))
+        return false;
+
+    if (frame->count == 0)
+    {
+        frame->dest = destNodeId;
+        frame->opened_at = millis();
+    }
+    frame->data[frame->length] = COALESCE_HEADER(port, payloadLen);
+    if (payloadLen != 0)
+        memcpy(frame->data + frame->length + 1, payload, payloadLen);
+    frame->length += 1 + payloadLen;
+    frame->count++;
+
+    if (frame->length >= this->max_length - 1)
+        this->send_frame(frame);    // Nothing more fits. If the queue is full, update() tries again
+    return true;
+}
+
+bool FrameCoalescer::flush(uint16_t destNodeId)
+{
+    for (int i = 0; i < NEOMESH_COALESCE_DESTINATIONS; i++)
+    {
+        if (this->frames[i].dest == destNodeId && this->frames[i].count != 0)
+            return this->send_frame(&this->frames[i]);
+    }
+    return true;
+}
+
+bool FrameCoalescer::flush()
+{
+    bool ok = true;
+    for (int i = 0; i < NEOMESH_COALESCE_DESTINATIONS; i++)
+    {
+        if (this->frames[i].count != 0 && !this->send_frame(&this->frames[i]))
+            ok = false;
+    }
+    return ok;
+}
+
+uint32_t FrameCoalescer::update()
+{
+    uint32_t now = millis();
+    uint32_t next = NEOMESH_NO_DEADLINE;
+    for (int i = 0; i < NEOMESH_COALESCE_DESTINATIONS; i++)
+    {
+        tNcCoalesceFrame * frame = &this->frames[i];
+        if (frame->count == 0)
+            continue;
+
+        uint32_t waited = now - frame->opened_at;
+        if (waited >= NEOMESH_COALESCE_WINDOW_MS)
+        {
+            // If the queue is full, CTS makes room and wakes the MCU
+            this->send_frame(frame);
+            continue;
+        }
+        if (NEOMESH_COALESCE_WINDOW_MS - waited < next)
+            next = NEOMESH_COALESCE_WINDOW_MS - waited;
+    }
+    return next;
+}
+
+void FrameCoalescer::frame_received(tNcHostDataMessage * m)
+{
+    tNcHostDataMessage message = *m;
+    uint8_t i = 0;
+    while (i < m->payloadLength)
+    {
+        uint8_t header = m->payload[i];
+        uint8_t length = COALESCE_LENGTH(header);
+        if (i + 1 + length > m->payloadLength)
+        {
+            this->stats.malformed++;
+            return;
+        }
+
+        // A message for the reserved port would come back here
+        message.port = COALESCE_PORT(header);
+        message.payload = m->payload + i + 1;
+        message.payloadLength = length;
+        if (message.port != this->port)
+        {
+            this->stats.unpacked++;
+            this->neo->deliver_host_data(&message);
+        }
+        i += 1 + length;
+    }
+}
+
+uint8_t FrameCoalescer::get_max_message()
+{
+    return this->max_length - 1;    // Room for the sub-header
+}
+
+tNcCoalesceStats FrameCoalescer::get_stats()
+{
+    return this->stats;
+}
+
+/*******************************************************************************
+ *    Private Class/Functions
+ ******************************************************************************/
+
+tNcCoalesceFrame * FrameCoalescer::get_frame(uint16_t destNodeId)
+{
+    tNcCoalesceFrame * free_frame = nullptr;
+    tNcCoalesceFrame * oldest = nullptr;
+    for (int i = 0; i < NEOMESH_COALESCE_DESTINATIONS; i++)
+    {
+        tNcCoalesceFrame * frame = &this->frames[i];
+        if (frame->count == 0)
+        {
+            if (free_frame == nullptr)
+                free_frame = frame;
+            continue;
+        }
+        if (frame->dest == destNodeId)
+            return frame;
+        if (oldest == nullptr || (int32_t)(frame->opened_at - oldest->opened_at) < 0)
+            oldest = frame;
+    }
+    if (free_frame != nullptr)
+        return free_frame;
+
+    // All in use. Send the frame that has waited longest to make room
+    return this->send_frame(oldest) ? oldest : nullptr;
+}
+
+bool FrameCoalescer::send_frame(tNcCoalesceFrame * frame)
+{
+    bool sent;
+    if (frame->count == 1)
+        sent = this->send_direct(frame->dest, COALESCE_PORT(frame->data[0]), frame->data + 1, frame->length - 1);
+    else
+        sent = this->send_direct(frame->dest, this->port, frame->data, frame->length);
+    if (!sent)
+        return false;
+
+    frame->length = 0;
+    frame->count = 0;
+    return true;
+}
+
+bool FrameCoalescer::send_direct(uint16_t destNodeId, uint8_t port, uint8_t * payload, uint8_t payloadLen)
+{
+    NcApiErrorCodes status;
+    if (this->acknowledged)
+        status = this->neo->send_acknowledged(destNodeId, port, payload, payloadLen);
+    else
+        status = this->neo->send_unacknowledged(destNodeId, port, payload, payloadLen);
+    if (status != NCAPI_OK)
+        return false;
+    this->stats.frames++;
+    return true;
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * @file FrameCoalescer.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef FRAME_COALESCER_H
+#define FRAME_COALESCER_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NeoMesh.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#ifndef NEOMESH_COALESCE_PORT
+#define NEOMESH_COALESCE_PORT 4             //!< Port reserved for coalesced frames
+#endif
+
+#ifndef NEOMESH_COALESCE_WINDOW_MS
+#define NEOMESH_COALESCE_WINDOW_MS 50       //!< Time the first message in a frame may wait for others
+#endif
+
+#ifndef NEOMESH_COALESCE_DESTINATIONS
+#define NEOMESH_COALESCE_DESTINATIONS 4     //!< Destinations that can have a frame being filled at once
+#endif
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief A frame being filled for one destination
+*/
+typedef struct {
+    uint16_t dest;          // 0 if unused
+    uint8_t length;
+    uint8_t count;          // Messages in data
+    uint32_t opened_at;     // millis() when the first message was added
+    uint8_t data[NCAPI_MAX_PAYLOAD_LENGTH];     // Only NEOMESH_MAX_UNACK_PAYLOAD_LENGTH bytes are used when unacknowledged
+} tNcCoalesceFrame;
+
+/**
+* @brief Counters for a frame coalescer
+*/
+typedef struct {
+    uint32_t messages;      // Messages passed to send
+    uint32_t frames;        // Frames queued, coalesced or not
+    uint32_t unpacked;      // Messages unpacked from received frames
+    uint32_t malformed;     // Received frames that ended in the middle of a message
+} tNcCoalesceStats;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Packs small messages to the same destination into one frame
+* @details Every message gets a one byte sub-header with its port in the high 3 bits and its
+* length in the low 5 bits. A frame is sent on the reserved port when the next message does not
+* fit, when its first message has waited NEOMESH_COALESCE_WINDOW_MS, or on flush(). A frame with a
+* single message is sent without sub-header on the message's own port. The receiving side unpacks
+* frames on the reserved port and passes each message to NeoMesh::deliver_host_data, so it reaches
+* the port handler of its own port. Both nodes must use the same reserved port
+*/
+class FrameCoalescer
+{
+public:
+    /**
+    * @brief Construct a coalescer and register it as handler for host data on the reserved port
+    * @param neo The NeoMesh object to send and receive through
+    * @param port The reserved port
+    * @param acknowledged True to send frames with send_acknowledged. False for send_unacknowledged
+    */
+    FrameCoalescer(NeoMesh * neo, uint8_t port = NEOMESH_COALESCE_PORT, bool acknowledged = false);
+
+    /**
+    * @brief Add a message to the frame for its destination
+    * @details Messages longer than get_max_message() are sent right away on their own, after the
+    * frame already being filled for the destination. When sending
+    * unacknowledged, they can be at most NEOMESH_MAX_UNACK_PAYLOAD_LENGTH bytes
+    * @param destNodeId The receiver
+    * @param port The port the message is for. Not the reserved port
+    * @param payload The message
+    * @param payloadLen Length of the message
+    * @return False if the message could not be added or sent
+    */
+    bool send(uint16_t destNodeId, uint8_t port, const uint8_t * payload, uint8_t payloadLen);
+
+    /**
+    * @brief Send the frame for a destination now
+    * @return True if the frame was queued or was empty. False if the transmit queue is full
+    */
+    bool flush(uint16_t destNodeId);
+
+    /**
+    * @brief Send all frames now
+    * @return False if any frame could not be queued
+    */
+    bool flush();
+
+    /**
+    * @brief Sends frames whose first message has waited for the window. Call from main loop
+    * @return Time in ms until a frame must be sent. NEOMESH_NO_DEADLINE if all are empty
+    */
+    uint32_t update();
+
+    /**
+    * @brief Unpack a received frame. Called through the port handler
+    */
+    void frame_received(tNcHostDataMessage * m);
+
+    /**
+    * @brief Get length of the longest message that is packed into a frame with others
+    */
+    uint8_t get_max_message();
+
+    /**
+    * @brief Get counters
+    */
+    tNcCoalesceStats get_stats();
+
+private:
+    NeoMesh * neo;
+    uint8_t port;
+    bool acknowledged;
+    uint8_t max_length;     // Frame size for the chosen send function
+    tNcCoalesceFrame frames[NEOMESH_COALESCE_DESTINATIONS] = {};
+    tNcCoalesceStats stats = {};
+
+    tNcCoalesceFrame * get_frame(uint16_t destNodeId);
+    bool send_frame(tNcCoalesceFrame * frame);
+    bool send_direct(uint16_t destNodeId, uint8_t port, uint8_t * payload, uint8_t payloadLen);
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // FRAME_COALESCER_H
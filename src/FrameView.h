@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * @file FrameView.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef FRAME_VIEW_H
+#define FRAME_VIEW_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NcApi.h"
+#include "NeoParser.h"
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+
+/**
+* @brief Read only view of a raw frame as delivered to read_callback, kept with take_rx_frame
+* or found in tNcMessage::raw
+* @details Nothing is decoded until an accessor is called, and each accessor only reads the
+* bytes it needs. The view does not copy the frame, so it is only valid as long as the frame is
+*/
+class FrameView
+{
+public:
+    explicit FrameView(const uint8_t * msg) : msg(msg) {}
+
+    /**
+    * @brief Get message type. See NcApiMessageType
+    */
+    uint8_t type() const { return this->msg[0]; }
+
+    /**
+    * @brief Get pointer to the raw frame
+    */
+    const uint8_t * raw() const { return this->msg; }
+
+    /**
+    * @brief See if bytes 2 and 3 of the frame are the id of the node it came from
+    */
+    bool has_origin() const
+    {
+        uint8_t type = this->type();
+        return (type >= HostAckEnum && type <= HostUappDataDropped) || type == NetCmdReplyEnum;
+    }
+
+    /**
+    * @brief Get the node the frame came from. Only valid if has_origin()
+    */
+    uint16_t origin() const { return this->be16(2); }
+
+protected:
+    const uint8_t * msg;
+
+    uint16_t be16(uint8_t at) const
+    {
+        return ((uint16_t)this->msg[at] << 8) | this->msg[at + 1];
+    }
+
+    uint32_t be32(uint8_t at) const
+    {
+        return ((uint32_t)this->msg[at] << 24) | ((uint32_t)this->msg[at + 1] << 16)
+            | ((uint32_t)this->msg[at + 2] << 8) | this->msg[at + 3];
+    }
+};
+
+/**
+* @brief View of a HostAck or HostNAck frame
+*/
+class HostAckView : public FrameView
+{
+public:
+    explicit HostAckView(const uint8_t * msg) : FrameView(msg) {}
+};
+
+/**
+* @brief View of a HostUappDataSend or HostUappDataDropped frame
+*/
+class HostUappStatusView : public FrameView
+{
+public:
+    explicit HostUappStatusView(const uint8_t * msg) : FrameView(msg) {}
+    uint16_t seq() const { return this->be16(4) & 0x0fff; }
+};
+
+/**
+* @brief View of one of the four host data frames
+* @details The layout is fixed by TYPE at compile time, so every accessor is a few loads.
+* Use the typedefs below rather than the template directly
+*/
+template <uint8_t TYPE>
+class HostDataView : public FrameView
+{
+public:
+    explicit HostDataView(const uint8_t * msg) : FrameView(msg) {}
+
+    static const bool hapa = TYPE == HostDataHapaEnum || TYPE == HostUappDataHapaEnum;
+    static const bool uapp = TYPE == HostUappDataEnum || TYPE == HostUappDataHapaEnum;
+    static const uint8_t port_at = hapa ? 8 : 6;
+    static const uint8_t header_size = hapa ? (uapp ? NCAPI_HOSTUAPPDATAHAPA_HEADER_SIZE : NCAPI_HOSTDATAHAPA_HEADER_SIZE)
+                                            : (uapp ? NCAPI_HOSTUAPPDATA_HEADER_SIZE : NCAPI_HOSTDATA_HEADER_SIZE);
+
+    /**
+    * @brief Get package age. 32 bits for HAPA frames, otherwise 16 bits, as packageAge in the structs
+    */
+    uint32_t age() const { return hapa ? this->be32(4) : this->be16(4); }
+
+    uint8_t port() const { return this->msg[port_at]; }
+
+    /**
+    * @brief Get appSeqNo. Always 0 for acknowledged host data
+    */
+    uint16_t seq() const { return uapp ? this->be16(port_at + 1) & 0x0fff : 0; }
+
+    const uint8_t * payload() const { return this->msg + NCAPI_HOST_PREFIX_SIZE + header_size; }
+    uint8_t payload_length() const { return this->msg[1] - header_size; }
+};
+
+typedef HostDataView<HostDataEnum> tNcHostDataView;
+typedef HostDataView<HostDataHapaEnum> tNcHostDataHapaView;
+typedef HostDataView<HostUappDataEnum> tNcHostUappDataView;
+typedef HostDataView<HostUappDataHapaEnum> tNcHostUappDataHapaView;
+
+/**
+* @brief View of a frame of any of the four host data types, when the type is only known at run time
+* @details Each accessor selects the layout from the type byte, so the typed views above are
+* cheaper when the type is known
+*/
+class AnyHostDataView : public FrameView
+{
+public:
+    explicit AnyHostDataView(const uint8_t * msg) : FrameView(msg) {}
+
+    static bool is_host_data(uint8_t type) { return type >= HostDataEnum && type <= HostUappDataHapaEnum; }
+
+    bool hapa() const { return this->type() == HostDataHapaEnum || this->type() == HostUappDataHapaEnum; }
+    bool uapp() const { return this->type() == HostUappDataEnum || this->type() == HostUappDataHapaEnum; }
+
+    uint8_t port_at() const
+    {
+        if (this->hapa())
+            return tNcHostDataHapaView::port_at;
+        return tNcHostDataView::port_at;
+    }
+
+    uint8_t header_size() const
+    {
+        switch (this->type())
+        {
+            case HostDataHapaEnum: return tNcHostDataHapaView::header_size;
+            case HostUappDataEnum: return tNcHostUappDataView::header_size;
+            case HostUappDataHapaEnum: return tNcHostUappDataHapaView::header_size;
+            default: return tNcHostDataView::header_size;
+        }
+    }
+
+    uint32_t age() const { return this->hapa() ? this->be32(4) : this->be16(4); }
+    uint8_t port() const { return this->msg[this->port_at()]; }
+    uint16_t seq() const { return this->uapp() ? this->be16(this->port_at() + 1) & 0x0fff : 0; }
+    const uint8_t * payload() const { return this->msg + NCAPI_HOST_PREFIX_SIZE + this->header_size(); }
+    uint8_t payload_length() const { return this->msg[1] - this->header_size(); }
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // FRAME_VIEW_H
@@ -0,0 +1,189 @@
+/*******************************************************************************
+ * @file PayloadSchema.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef PAYLOAD_SCHEMA_H
+#define PAYLOAD_SCHEMA_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "NcApi.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+/**
+* @brief Declare a field of a PayloadSchema from a struct member
+*/
+#define NEOMESH_FIELD(STRUCT, MEMBER) PayloadField<STRUCT, decltype(STRUCT::MEMBER), &STRUCT::MEMBER>
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+
+/**
+* @brief Big endian reading and writing of a field type
+* @details Integers of 1, 2 and 4 bytes, signed or not, bool and float are supported.
+* Other types fail to compile
+*/
+template <typename T, uint8_t SIZE = sizeof(T)> struct BigEndian;
+
+template <typename T> struct BigEndian<T, 1>
+{
+    static void write(T value, uint8_t *out) { out[0] = (uint8_t)value; }
+    static T read(const uint8_t *in) { return (T)in[0]; }
+};
+
+template <typename T> struct BigEndian<T, 2>
+{
+    static void write(T value, uint8_t *out)
+    {
+        uint16_t v = (uint16_t)value;
+        out[0] = v >> 8;
+        out[1] = v;
+    }
+    static T read(const uint8_t *in) { return (T)(((uint16_t)in[0] << 8) | in[1]); }
+};
+
+template <typename T> struct BigEndian<T, 4>
+{
+    static void write(T value, uint8_t *out)
+    {
+        uint32_t v = (uint32_t)value;
+        out[0] = v >> 24;
+        out[1] = v >> 16;
+        out[2] = v >> 8;
+        out[3] = v;
+    }
+    static T read(const uint8_t *in)
+    {
+        return (T)(((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3]);
+    }
+};
+
+template <> struct BigEndian<float, 4>
+{
+    static void write(float value, uint8_t *out)
+    {
+        uint32_t v;
+        memcpy(&v, &value, 4);
+        BigEndian<uint32_t>::write(v, out);
+    }
+    static float read(const uint8_t *in)
+    {
+        uint32_t v = BigEndian<uint32_t>::read(in);
+        float value;
+        memcpy(&value, &v, 4);
+        return value;
+    }
+};
+
+template <> struct BigEndian<bool, 1>
+{
+    static void write(bool value, uint8_t *out) { out[0] = value ? 1 : 0; }
+    static bool read(const uint8_t *in) { return in[0] != 0; }
+};
+
+/**
+* @brief One field of a payload. Use NEOMESH_FIELD to declare it
+*/
+template <typename S, typename T, T S::*MEMBER>
+struct PayloadField
+{
+    static const uint8_t size = sizeof(T);
+
+    static void encode(const S &value, uint8_t *out) { BigEndian<T>::write(value.*MEMBER, out); }
+    static void decode(const uint8_t *in, S &value) { value.*MEMBER = BigEndian<T>::read(in); }
+};
+
+/**
+* @brief Encodes and decodes the fields in order, each at an offset fixed at compile time
+*/
+template <typename S, typename... FIELDS> struct PayloadFields;
+
+template <typename S> struct PayloadFields<S>
+{
+    static const uint8_t size = 0;
+
+    static void encode(const S &, uint8_t *) {}
+    static void decode(const uint8_t *, S &) {}
+};
+
+template <typename S, typename FIELD, typename... REST> struct PayloadFields<S, FIELD, REST...>
+{
+    static const uint8_t size = FIELD::size + PayloadFields<S, REST...>::size;
+
+    static void encode(const S &value, uint8_t *out)
+    {
+        FIELD::encode(value, out);
+        PayloadFields<S, REST...>::encode(value, out + FIELD::size);
+    }
+
+    static void decode(const uint8_t *in, S &value)
+    {
+        FIELD::decode(in, value);
+        PayloadFields<S, REST...>::decode(in + FIELD::size, value);
+    }
+};
+
+/**
+* @brief Fixed binary layout of a payload, declared as a list of struct members
+* @details The fields are packed in the order listed, big endian, without padding.
+* The layout must fit in NCAPI_MAX_PAYLOAD_LENGTH, which is checked when the schema is compiled.
+* Example:
+*
+*     struct Reading { uint16_t temperature; int8_t rssi; uint32_t time; };
+*     typedef PayloadSchema<Reading, NEOMESH_FIELD(Reading, temperature),
+*         NEOMESH_FIELD(Reading, rssi), NEOMESH_FIELD(Reading, time)> ReadingSchema;
+*
+*     neo.send_acknowledged_as<ReadingSchema>(dest, 1, reading);
+*     neo.register_schema_handler<ReadingSchema, on_reading>(HostDataEnum, 1);
+*/
+template <typename S, typename... FIELDS>
+struct PayloadSchema
+{
+    typedef S Type;
+    static const uint8_t size = PayloadFields<S, FIELDS...>::size;
+
+    static_assert(size <= NCAPI_MAX_PAYLOAD_LENGTH, "Payload schema does not fit in one frame");
+
+    /**
+    * @brief Write value to out, which must have room for size bytes
+    */
+    static void encode(const S &value, uint8_t *out)
+    {
+        PayloadFields<S, FIELDS...>::encode(value, out);
+    }
+
+    /**
+    * @brief Read value from a received payload
+    * @return False, leaving value untouched, if length is not size
+    */
+    static bool decode(const uint8_t *in, uint8_t length, S &value)
+    {
+        if (length != size)
+            return false;
+        PayloadFields<S, FIELDS...>::decode(in, value);
+        return true;
+    }
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // PAYLOAD_SCHEMA_H
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * @file ReportBatcher.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "ReportBatcher.h"
+#include "NeoMesh.h"
+
+#include <string.h>
+
+#include <Arduino.h>
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+ReportBatcher::ReportBatcher(NeoMesh * neo, uint16_t destNodeId, uint8_t port, bool acknowledged)
+{
+    this->neo = neo;
+    this->dest = destNodeId;
+    this->port = port;
+    this->acknowledged = acknowledged;
+    this->max_length = acknowledged ? NCAPI_MAX_PAYLOAD_LENGTH : NEOMESH_MAX_UNACK_PAYLOAD_LENGTH;
+}
+
+bool ReportBatcher::add(const uint8_t * sample, uint8_t length)
+{
+    if (sample == nullptr || length == 0 || length > this->max_length)
+        return false;
+
+    if (this->length + length > this->max_length && !this->flush())
+    {
+        this->stats.dropped++;
+        return false;
+    }
+
+    if (this->length == 0)
+        this->first_sample_at = millis();
+    memcpy(this->frame + this->length, sample, length);
+    this->length += length;
+    this->stats.samples++;
+
+    if (this->length == this->max_length)
+        this->flush();  // Full. If the queue is full, the next add or update tries again
+    return true;
+}
+
+bool ReportBatcher::flush()
+{
+    if (this->length == 0)
+        return true;
+
+    NcApiErrorCodes status;
+    if (this->acknowledged)
+        status = this->neo->send_acknowledged(this->dest, this->port, this->frame, this->length);
+    else
+        status = this->neo->send_unacknowledged(this->dest, this->port, this->frame, this->length);
+    if (status != NCAPI_OK)
+        return false;
+
+    uint32_t now = millis();
+    if (!this->sent_before || now - this->last_sent_at >= NEOMESH_RADIO_WINDOW_MS)
+        this->stats.radio_windows++;
+    this->sent_before = true;
+    this->last_sent_at = now;
+    this->stats.frames++;
+    this->stats.bytes += this->length;
+    this->length = 0;
+    return true;
+}
+
+uint32_t ReportBatcher::update()
+{
+    if (this->length == 0)
+        return NEOMESH_NO_DEADLINE;
+
+    uint32_t age = millis() - this->first_sample_at;
+    if (age < this->max_age_ms)
+        return this->max_age_ms - age;
+
+    // If the transmit queue is full, the next call tries again. CTS makes room and wakes the MCU
+    this->flush();
+    return NEOMESH_NO_DEADLINE;
+}
+
+void ReportBatcher::set_max_age(uint32_t max_age_ms)
+{
+    this->max_age_ms = max_age_ms;
+}
+
+uint8_t ReportBatcher::get_max_length()
+{
+    return this->max_length;
+}
+
+uint8_t ReportBatcher::get_pending_length()
+{
+    return this->length;
+}
+
+tNcBatchStats ReportBatcher::get_stats()
+{
+    return this->stats;
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * @file ReportBatcher.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef REPORT_BATCHER_H
+#define REPORT_BATCHER_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NcApi.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#ifndef NEOMESH_BATCH_MAX_AGE_MS
+#define NEOMESH_BATCH_MAX_AGE_MS 60000UL    //!< Default time the oldest sample may wait before the frame is sent
+#endif
+
+#ifndef NEOMESH_RADIO_WINDOW_MS
+#define NEOMESH_RADIO_WINDOW_MS 1000        //!< Frames sent closer together than this are counted as one radio-on window
+#endif
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief Counters for a report batcher. Frames, bytes and radio-on windows are what costs energy
+*/
+typedef struct {
+    uint32_t samples;       // Samples added
+    uint32_t dropped;       // Samples that did not fit because the frame could not be sent
+    uint32_t frames;        // Frames queued
+    uint32_t bytes;         // Payload bytes queued
+    uint32_t radio_windows; // Groups of frames sent within NEOMESH_RADIO_WINDOW_MS of each other
+} tNcBatchStats;
+
+class NeoMesh;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Collects small samples into full frames to one destination and port
+* @details Samples are appended to a frame of up to NCAPI_MAX_PAYLOAD_LENGTH bytes, or
+* NEOMESH_MAX_UNACK_PAYLOAD_LENGTH bytes when sent unacknowledged. The frame is
+* sent when the next sample does not fit, when the oldest sample has waited for the maximum age,
+* or when flush() is called. The samples are sent back to back, so the receiver must know their layout
+*/
+class ReportBatcher
+{
+public:
+    /**
+    * @brief Construct a batcher
+    * @param neo The NeoMesh object to send through
+    * @param destNodeId The receiver of the frames
+    * @param port The port to send to
+    * @param acknowledged True to send with send_acknowledged. False for send_unacknowledged
+    */
+    ReportBatcher(NeoMesh * neo, uint16_t destNodeId, uint8_t port, bool acknowledged = false);
+
+    /**
+    * @brief Add a sample to the frame
+    * @details If the sample does not fit, the frame is sent first
+    * @param sample The sample
+    * @param length Length of the sample. At most the frame size, see get_max_length()
+    * @return True if the sample was added. False if it did not fit and the frame could not be sent
+    */
+    bool add(const uint8_t * sample, uint8_t length);
+
+    /**
+    * @brief Send the frame now, if it holds any samples
+    * @return True if the frame was queued or was empty. False if the transmit queue is full
+    */
+    bool flush();
+
+    /**
+    * @brief Sends the frame when the oldest sample has waited for the maximum age. Call from main loop
+    * @return Time in ms until the frame must be sent. NEOMESH_NO_DEADLINE if it is empty
+    */
+    uint32_t update();
+
+    /**
+    * @brief Set how long the oldest sample may wait before the frame is sent
+    * @param max_age_ms Time in ms
+    */
+    void set_max_age(uint32_t max_age_ms);
+
+    /**
+    * @brief Get number of bytes a frame can hold
+    */
+    uint8_t get_max_length();
+
+    /**
+    * @brief Get number of bytes in the frame that has not been sent yet
+    */
+    uint8_t get_pending_length();
+
+    /**
+    * @brief Get counters
+    */
+    tNcBatchStats get_stats();
+
+private:
+    NeoMesh * neo;
+    uint16_t dest;
+    uint8_t port;
+    bool acknowledged;
+    uint8_t max_length;             // Frame size for the chosen send function
+    uint32_t max_age_ms = NEOMESH_BATCH_MAX_AGE_MS;
+
+    uint8_t frame[NCAPI_MAX_PAYLOAD_LENGTH];
+    uint8_t length = 0;
+    uint32_t first_sample_at = 0;   // millis() when the oldest sample in the frame was added
+
+    bool sent_before = false;
+    uint32_t last_sent_at = 0;      // millis() when the last frame was queued
+    tNcBatchStats stats = {};
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // REPORT_BATCHER_H
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * @file RxFilter.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "RxFilter.h"
+#include "FrameView.h"
+#include "NeoParser.h"
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+bool RxFilter::accept(const uint8_t * msg, uint8_t msgLength)
+{
+    if (msgLength < NCAPI_HOST_PREFIX_SIZE)
+        return true;
+
+    FrameView view(msg);
+    uint8_t type = view.type();
+    if (type >= NEOMESH_RX_TYPE_FIRST && type <= NEOMESH_RX_TYPE_LAST
+        && !(this->type_mask & ((uint32_t)1 << (type - NEOMESH_RX_TYPE_FIRST))))
+    {
+        this->dropped++;
+        return false;
+    }
+
+    if (AnyHostDataView::is_host_data(type))
+    {
+        AnyHostDataView host(msg);
+        if (host.port_at() < msgLength && host.port() < 8 && !(this->port_mask & (1 << host.port())))
+        {
+            this->dropped++;
+            return false;
+        }
+    }
+
+    if (view.has_origin() && this->origin_mode != NEOMESH_ORIGIN_ANY && msgLength >= 4)
+    {
+        bool listed = this->origin_listed(view.origin());
+        if (listed != (this->origin_mode == NEOMESH_ORIGIN_ALLOW))
+        {
+            this->dropped++;
+            return false;
+        }
+    }
+    return true;
+}
+
+void RxFilter::set_type(uint8_t type, bool enabled)
+{
+    if (type < NEOMESH_RX_TYPE_FIRST || type > NEOMESH_RX_TYPE_LAST)
+        return;
+    uint32_t bit = (uint32_t)1 << (type - NEOMESH_RX_TYPE_FIRST);
+    if (enabled)
+        this->type_mask |= bit;
+    else
+        this->type_mask &= ~bit;
+}
+
+void RxFilter::set_ports(uint8_t port_mask)
+{
+    this->port_mask = port_mask;
+}
+
+void RxFilter::set_origin_mode(tNcOriginFilterMode mode)
+{
+    this->origin_mode = mode;
+}
+
+bool RxFilter::add_origin(uint16_t originId)
+{
+    if (originId == 0 || this->origin_listed(originId))
+        return originId != 0;
+
+    // Node id 0 is never an origin, so it marks an unused entry
+    for (int i = 0; i < NEOMESH_ORIGIN_FILTER_SIZE; i++)
+    {
+        if (this->origins[i] == 0)
+        {
+            this->origins[i] = originId;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RxFilter::remove_origin(uint16_t originId)
+{
+    for (int i = 0; i < NEOMESH_ORIGIN_FILTER_SIZE; i++)
+    {
+        if (this->origins[i] == originId)
+            this->origins[i] = 0;
+    }
+}
+
+void RxFilter::clear_origins()
+{
+    for (int i = 0; i < NEOMESH_ORIGIN_FILTER_SIZE; i++)
+        this->origins[i] = 0;
+}
+
+uint32_t RxFilter::get_dropped_count()
+{
+    return this->dropped;
+}
+
+/*******************************************************************************
+ *    Private Class/Functions
+ ******************************************************************************/
+
+bool RxFilter::origin_listed(uint16_t originId)
+{
+    if (originId == 0)
+        return false;
+    for (int i = 0; i < NEOMESH_ORIGIN_FILTER_SIZE; i++)
+    {
+        if (this->origins[i] == originId)
+            return true;
+    }
+    return false;
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
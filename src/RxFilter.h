@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * @file RxFilter.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef RX_FILTER_H
+#define RX_FILTER_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NcApi.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#ifndef NEOMESH_ORIGIN_FILTER_SIZE
+#define NEOMESH_ORIGIN_FILTER_SIZE 8    //!< Number of node ids in the origin filter
+#endif
+
+#define NEOMESH_RX_TYPE_FIRST 0x50  // HostAckEnum. Lowest message type that can be filtered
+#define NEOMESH_RX_TYPE_LAST 0x6f   // Highest message type that can be filtered
+#define NEOMESH_ALL_PORTS 0xff
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief How the node ids in the origin filter are used
+*/
+typedef enum {
+    /**
+    * @brief Origin is not checked
+    */
+    NEOMESH_ORIGIN_ANY = 0,
+
+    /**
+    * @brief Only messages from node ids in the filter are accepted
+    */
+    NEOMESH_ORIGIN_ALLOW = 1,
+
+    /**
+    * @brief Messages from node ids in the filter are dropped
+    */
+    NEOMESH_ORIGIN_DENY = 2
+} tNcOriginFilterMode;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Decides from the header bytes of a received frame whether it should be handled at all
+* @details Checked before a frame is copied or decoded and before any callback, so frames the
+* application ignores cost only a few comparisons. The port filter applies to the four host data
+* messages. The origin filter applies to every message that carries an origin id
+*/
+class RxFilter
+{
+public:
+    /**
+    * @brief Check a received frame
+    * @param msg The frame, starting with the message type
+    * @param msgLength Length of the frame
+    * @return True if the frame should be handled
+    */
+    bool accept(const uint8_t * msg, uint8_t msgLength);
+
+    /**
+    * @brief Enable or disable handling of a message type
+    * @param type NcApiMessageType from HostAckEnum and up
+    * @param enabled False to drop all messages of the type
+    */
+    void set_type(uint8_t type, bool enabled);
+
+    /**
+    * @brief Set which ports host data is accepted on
+    * @param port_mask Bit n set to accept port n
+    */
+    void set_ports(uint8_t port_mask);
+
+    /**
+    * @brief Set how the origin filter is used
+    */
+    void set_origin_mode(tNcOriginFilterMode mode);
+
+    /**
+    * @brief Add a node id to the origin filter
+    * @return False if the filter is full
+    */
+    bool add_origin(uint16_t originId);
+
+    /**
+    * @brief Remove a node id from the origin filter
+    */
+    void remove_origin(uint16_t originId);
+
+    /**
+    * @brief Remove all node ids from the origin filter
+    */
+    void clear_origins();
+
+    /**
+    * @brief Get number of frames dropped by the filter
+    */
+    uint32_t get_dropped_count();
+
+private:
+    uint32_t type_mask = 0xffffffff;    // Bit n set if type NEOMESH_RX_TYPE_FIRST + n is handled
+    uint8_t port_mask = NEOMESH_ALL_PORTS;
+    tNcOriginFilterMode origin_mode = NEOMESH_ORIGIN_ANY;
+    uint16_t origins[NEOMESH_ORIGIN_FILTER_SIZE] = {0};
+    uint32_t dropped = 0;
+
+    bool origin_listed(uint16_t originId);
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // RX_FILTER_H
@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * @file RxPool.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "RxPool.h"
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+tNcRxFrame * RxPool::alloc()
+{
+    for (int i = 0; i < NEOMESH_RX_POOL_SIZE; i++)
+    {
+        if (!this->used[i])
+        {
+            this->used[i] = true;
+            return &this->frames[i];
+        }
+    }
+    return nullptr;
+}
+
+void RxPool::release(tNcRxFrame * frame)
+{
+    if (frame == nullptr)
+        return;
+    int i = frame - this->frames;
+    if (i < 0 || i >= NEOMESH_RX_POOL_SIZE)
+        return;
+    this->used[i] = false;
+}
+
+uint8_t RxPool::available()
+{
+    uint8_t count = 0;
+    for (int i = 0; i < NEOMESH_RX_POOL_SIZE; i++)
+    {
+        if (!this->used[i])
+            count++;
+    }
+    return count;
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
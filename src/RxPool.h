@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * @file RxPool.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef RX_POOL_H
+#define RX_POOL_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NcApi.h"
+#include "NeoParser.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#ifndef NEOMESH_RX_POOL_SIZE
+#define NEOMESH_RX_POOL_SIZE 4  //!< Number of received frames that can be kept at once
+#endif
+
+// Largest frames NcApi parses: host data with a full payload, and the extended neighbor list reply.
+// Network command responses have a payload no longer than host data, so they fit as well
+#define NEOMESH_RX_HOST_DATA_MAX_FRAME (NCAPI_HOSTUAPPDATAHAPA_MIN_LENGTH + NCAPI_MAX_PAYLOAD_LENGTH)
+#define NEOMESH_RX_NEIGHBOR_LIST_MAX_FRAME (NCAPI_HOST_PREFIX_SIZE + NCAPI_NEIGHBORLISTREPLY_EX_LENGTH)
+
+#ifndef NEOMESH_RX_BLOCK_SIZE
+#define NEOMESH_RX_BLOCK_SIZE (NEOMESH_RX_HOST_DATA_MAX_FRAME > NEOMESH_RX_NEIGHBOR_LIST_MAX_FRAME \
+    ? NEOMESH_RX_HOST_DATA_MAX_FRAME : NEOMESH_RX_NEIGHBOR_LIST_MAX_FRAME) //!< Largest frame that fits in a block. Larger frames can not be kept
+#endif
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief A received frame as it came from the module
+* @details data starts with the message type, and can be decoded with the NcApiGetMsgAs functions
+*/
+typedef struct {
+    uint8_t length;
+    uint8_t data[NEOMESH_RX_BLOCK_SIZE];
+} tNcRxFrame;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Fixed number of blocks for received frames
+* @details Blocks are handed out and returned by pointer, so a frame is never copied
+* once it is in the pool, and no heap is used
+*/
+class RxPool
+{
+public:
+    /**
+    * @brief Take a free block
+    * @return Pointer to the block, or nullptr if all blocks are in use
+    */
+    tNcRxFrame * alloc();
+
+    /**
+    * @brief Return a block to the pool
+    * @param frame A block returned by alloc(). nullptr is ignored
+    */
+    void release(tNcRxFrame * frame);
+
+    /**
+    * @brief Get number of free blocks
+    */
+    uint8_t available();
+
+private:
+    tNcRxFrame frames[NEOMESH_RX_POOL_SIZE];
+    bool used[NEOMESH_RX_POOL_SIZE] = {false};
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // RX_POOL_H
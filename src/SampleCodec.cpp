@@ -0,0 +1,220 @@
+/*******************************************************************************
+ * @file SampleCodec.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "SampleCodec.h"
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+uint8_t SampleCodec::encode(const int32_t * samples, uint16_t count, uint8_t * out, uint8_t out_size, uint16_t * used)
+{
+    *used = 0;
+    if (count == 0)
+        return 0;
+    if (count > NEOMESH_CODEC_MAX_SAMPLES)
+        count = NEOMESH_CODEC_MAX_SAMPLES;
+    uint32_t first = SampleCodec::zigzag((uint32_t)samples[0]);
+    uint16_t start = NEOMESH_CODEC_HEADER_SIZE + SampleCodec::varint_size(first);
+    if (start > out_size)
+        return 0;
+
+    // Find how many samples each mode fits
+    uint16_t varint_count = 1, varint_length = start;
+    uint16_t pack_count = 1;
+    uint8_t pack_width = 0;
+    bool varint_full = false;
+    bool pack_full = false;
+    for (uint16_t i = 1; i < count; i++)
+    {
+        uint32_t delta = SampleCodec::zigzag((uint32_t)samples[i] - (uint32_t)samples[i - 1]);
+
+        if (!varint_full)
+        {
+            uint8_t size = SampleCodec::varint_size(delta);
+            if (varint_length + size <= out_size)
+            {
+                varint_length += size;
+                varint_count++;
+            }
+            else
+            {
+                varint_full = true;
+            }
+        }
+
+        if (!pack_full)
+        {
+            uint8_t width = SampleCodec::bit_width(delta);
+            if (width < pack_width)
+                width = pack_width;
+            if (start + ((uint32_t)i * width + 7) / 8 <= out_size)
+            {
+                pack_width = width;
+                pack_count = i + 1;
+            }
+            else
+            {
+                pack_full = true;
+            }
+        }
+
+        if (varint_full && pack_full)
+            break;
+    }
+
+    // Most samples wins. With equal count the shorter payload
+    uint16_t pack_length = start + ((uint32_t)(pack_count - 1) * pack_width + 7) / 8;
+    bool pack = pack_count > varint_count || (pack_count == varint_count && pack_length < varint_length);
+
+    uint16_t n = pack ? pack_count : varint_count;
+    out[0] = pack ? (CodecBitPack << 6) | pack_width : (CodecVarint << 6);
+    out[1] = n;
+    uint8_t * p = out + NEOMESH_CODEC_HEADER_SIZE;
+    p += SampleCodec::put_varint(p, first);
+
+    if (pack)
+    {
+        uint32_t bits = 0;
+        uint8_t bit_count = 0;
+        for (uint16_t i = 1; i < n; i++)
+        {
+            uint64_t delta = SampleCodec::zigzag((uint32_t)samples[i] - (uint32_t)samples[i - 1]);
+            // Write the value LSB first, a byte at a time, so it never needs more than 32 + 7 bits
+            uint64_t acc = (uint64_t)bits | delta << bit_count;
+            uint8_t total = bit_count + pack_width;
+            while (total >= 8)
+            {
+                *p++ = (uint8_t)acc;
+                acc >>= 8;
+                total -= 8;
+            }
+            bits = (uint32_t)acc;
+            bit_count = total;
+        }
+        if (bit_count != 0)
+            *p++ = (uint8_t)bits;
+    }
+    else
+    {
+        for (uint16_t i = 1; i < n; i++)
+            p += SampleCodec::put_varint(p, SampleCodec::zigzag((uint32_t)samples[i] - (uint32_t)samples[i - 1]));
+    }
+
+    *used = n;
+    return p - out;
+}
+
+uint16_t SampleCodec::decode(const uint8_t * in, uint8_t length, int32_t * samples, uint16_t max_samples)
+{
+    if (length < NEOMESH_CODEC_HEADER_SIZE + 1)
+        return 0;
+    uint8_t mode = in[0] >> 6;
+    uint8_t width = in[0] & 0x3f;
+    uint16_t n = in[1];
+    if (n == 0 || n > max_samples || width > 32 || (mode != CodecVarint && mode != CodecBitPack))
+        return 0;
+
+    const uint8_t * p = in + NEOMESH_CODEC_HEADER_SIZE;
+    const uint8_t * end = in + length;
+    uint32_t previous = 0;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        uint32_t value = 0;
+        if (i == 0 || mode == CodecVarint)
+        {
+            uint8_t shift = 0;
+            uint8_t b;
+            do
+            {
+                if (p >= end || shift > 28)
+                    return 0;
+                b = *p++;
+                value |= (uint32_t)(b & 0x7f) << shift;
+                shift += 7;
+            } while (b & 0x80);
+        }
+        else
+        {
+            // Bit i * width of the packed values, counted from the first packed byte
+            uint32_t bit = (uint32_t)(i - 1) * width;
+            const uint8_t * q = p + bit / 8;
+            uint8_t shift = bit % 8;
+            uint8_t bytes = (shift + width + 7) / 8;
+            if (q + bytes > end)
+                return 0;
+            uint64_t acc = 0;
+            for (uint8_t k = 0; k < bytes; k++)
+                acc |= (uint64_t)q[k] << (8 * k);
+            value = (uint32_t)(acc >> shift) & (width == 32 ? 0xffffffffUL : (1UL << width) - 1);
+        }
+
+        // Undo zig-zag, then add to the previous sample
+        uint32_t delta = (value >> 1) ^ (0 - (value & 1));
+        previous = i == 0 ? delta : previous + delta;
+        samples[i] = (int32_t)previous;
+    }
+    return n;
+}
+
+/*******************************************************************************
+ *    Private Class/Functions
+ ******************************************************************************/
+
+uint32_t SampleCodec::zigzag(uint32_t delta)
+{
+    return (delta << 1) ^ (0 - (delta >> 31));
+}
+
+uint8_t SampleCodec::varint_size(uint32_t value)
+{
+    uint8_t size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+uint8_t SampleCodec::bit_width(uint32_t value)
+{
+    uint8_t width = 0;
+    while (value != 0)
+    {
+        value >>= 1;
+        width++;
+    }
+    return width;
+}
+
+uint8_t SampleCodec::put_varint(uint8_t * out, uint32_t value)
+{
+    uint8_t size = 0;
+    while (value >= 0x80)
+    {
+        out[size++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    out[size++] = (uint8_t)value;
+    return size;
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
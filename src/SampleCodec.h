@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * @file SampleCodec.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef SAMPLE_CODEC_H
+#define SAMPLE_CODEC_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NcApi.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#define NEOMESH_CODEC_HEADER_SIZE 2     // Mode and bit width, sample count
+#define NEOMESH_CODEC_MAX_SAMPLES 255
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief How the differences between samples are stored. High 2 bits of the first byte
+*/
+typedef enum {
+    CodecVarint  = 0,   // Zig-zag encoded LEB128 varints. Good when most differences are small and a few are large
+    CodecBitPack = 1    // Zig-zag encoded, all with the bit width in the low 6 bits of the first byte. Good for steady noise
+} tNcCodecMode;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Packs a series of samples into one payload
+* @details The first sample is stored as a zig-zag varint, and each following sample as its
+* difference from the one before. The encoder picks the mode that fits the most samples.
+* Differences are taken modulo 2^32, so any int32_t series is decoded exactly
+*/
+class SampleCodec
+{
+public:
+    /**
+    * @brief Pack as many samples as fit
+    * @param samples The samples, oldest first
+    * @param count Number of samples
+    * @param out Buffer for the payload
+    * @param out_size Size of out. At least NEOMESH_CODEC_HEADER_SIZE + 5 to fit one sample
+    * @param[out] used Number of samples that were packed. Send the rest in the next payload
+    * @return Length of the payload. 0 if not even one sample fits
+    */
+    static uint8_t encode(const int32_t * samples, uint16_t count, uint8_t * out, uint8_t out_size, uint16_t * used);
+
+    /**
+    * @brief Unpack a payload made by encode
+    * @param in The payload
+    * @param length Length of the payload
+    * @param samples Buffer for the samples
+    * @param max_samples Size of samples. NEOMESH_CODEC_MAX_SAMPLES fits any payload
+    * @return Number of samples. 0 if the payload is not valid or does not fit in samples
+    */
+    static uint16_t decode(const uint8_t * in, uint8_t length, int32_t * samples, uint16_t max_samples);
+
+private:
+    static uint32_t zigzag(uint32_t delta);
+    static uint8_t varint_size(uint32_t value);
+    static uint8_t bit_width(uint32_t value);
+    static uint8_t put_varint(uint8_t * out, uint32_t value);
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // SAMPLE_CODEC_H
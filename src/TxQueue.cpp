@@ -0,0 +1,443 @@
+/*******************************************************************************
+ * @file TxQueue.cpp
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+/*******************************************************************************
+ *    Private Includes
+ ******************************************************************************/
+
+#include "TxQueue.h"
+
+#include <string.h>
+
+#include <Arduino.h>
+
+/*******************************************************************************
+ *    Public Class/Functions
+ ******************************************************************************/
+
+bool TxQueue::push(const tNcTxFrame * frame)
+{
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (this->used[i])
+            continue;
+
+        uint8_t flow = NEOMESH_NO_FLOW;
+        if (frame->priority != NEOMESH_PRIORITY_CONTROL)
+        {
+            // Control frames skip fair queueing and rate limits
+            flow = this->get_flow(frame->dest);
+            if (flow == NEOMESH_NO_FLOW)
+                return false;
+            if (this->cc_enabled && this->flows[flow].frames_per_minute == 0)
+            {
+                // New destination. Start out at the initial rate and let feedback adjust it
+                this->set_rate_limit(frame->dest, this->cc_initial, NEOMESH_AIMD_BURST);
+                this->flows[flow].adaptive = true;
+            }
+            this->flows[flow].backlog++;
+        }
+
+        this->frames[i] = *frame;
+        if (this->frames[i].priority >= NEOMESH_PRIORITY_COUNT)
+            this->frames[i].priority = NEOMESH_PRIORITY_BULK;
+        this->frames[i].flow = flow;
+        this->frames[i].ticket = this->next_ticket++;
+        this->used[i] = true;
+        return true;
+    }
+    return false;
+}
+
+tNcTxFrame * TxQueue::peek(uint8_t priority_limit)
+{
+    this->refill_tokens();
+    this->priority_limit = priority_limit;
+
+    tNcTxFrame * best = nullptr;
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (!this->used[i] || !this->eligible(&this->frames[i]))
+            continue;
+        tNcTxFrame * f = &this->frames[i];
+        if (best == nullptr
+            || f->priority < best->priority
+            || (f->priority == best->priority && (int32_t)(f->ticket - best->ticket) < 0))
+            best = f;
+    }
+
+    if (best == nullptr)
+        return nullptr;
+
+    uint8_t priority = best->priority;
+    if (this->burst >= NEOMESH_PRIORITY_BURST)
+    {
+        // Higher priorities have had their burst. Let the priority of the oldest lower priority frame go
+        tNcTxFrame * oldest = nullptr;
+        for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+        {
+            if (!this->used[i] || !this->eligible(&this->frames[i]))
+                continue;
+            tNcTxFrame * f = &this->frames[i];
+            if (f->priority > best->priority
+                && (oldest == nullptr || (int32_t)(f->ticket - oldest->ticket) < 0))
+                oldest = f;
+        }
+        if (oldest != nullptr)
+            priority = oldest->priority;
+    }
+    return this->select(priority);
+}
+
+void TxQueue::pop(tNcTxFrame * frame)
+{
+    int i = frame - this->frames;
+    if (i < 0 || i >= NEOMESH_TX_QUEUE_SIZE || !this->used[i])
+        return;
+    this->used[i] = false;
+
+    if (frame->flow != NEOMESH_NO_FLOW)
+    {
+        tNcTxFlow * flow = &this->flows[frame->flow];
+        flow->backlog--;
+        flow->deficit -= frame->length;
+        if (flow->frames_per_minute != 0)
+            flow->tokens -= NEOMESH_TOKENS_PER_FRAME;
+        if (flow->backlog == 0)
+            this->release_flow(frame->flow);
+    }
+
+    if (this->higher_priority_waiting(frame->priority))
+        this->burst = 0;    // A lower priority frame just had its turn
+    else if (this->lower_priority_waiting(frame->priority))
+        this->burst++;
+    else
+        this->burst = 0;
+}
+
+tNcTxFrame * TxQueue::next_expired(uint32_t now)
+{
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (this->used[i] && this->frames[i].has_deadline && (int32_t)(now - this->frames[i].deadline) >= 0)
+            return &this->frames[i];
+    }
+    return nullptr;
+}
+
+void TxQueue::remove(tNcTxFrame * frame)
+{
+    int i = frame - this->frames;
+    if (i < 0 || i >= NEOMESH_TX_QUEUE_SIZE || !this->used[i])
+        return;
+    this->used[i] = false;
+
+    if (frame->flow != NEOMESH_NO_FLOW)
+    {
+        this->flows[frame->flow].backlog--;
+        if (this->flows[frame->flow].backlog == 0)
+            this->release_flow(frame->flow);
+    }
+}
+
+bool TxQueue::contains(uint8_t type)
+{
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (this->used[i] && this->frames[i].type == type)
+            return true;
+    }
+    return false;
+}
+
+uint8_t TxQueue::count()
+{
+    uint8_t count = 0;
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (this->used[i])
+            count++;
+    }
+    return count;
+}
+
+uint32_t TxQueue::time_to_send(uint32_t now, uint8_t priority_limit)
+{
+    (void)now;
+    this->refill_tokens();
+
+    uint32_t wait = NEOMESH_NO_DEADLINE;
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (!this->used[i] || this->frames[i].priority >= priority_limit)
+            continue;
+        uint8_t flow = this->frames[i].flow;
+        if (this->flow_allowed(flow))
+            return 0;
+
+        // Tokens are refilled by frames_per_minute per ms
+        tNcTxFlow * f = &this->flows[flow];
+        uint32_t missing = NEOMESH_TOKENS_PER_FRAME - f->tokens;
+        uint32_t ms = (missing + f->frames_per_minute - 1) / f->frames_per_minute;
+        if (ms < wait)
+            wait = ms;
+    }
+    return wait;
+}
+
+uint32_t TxQueue::time_to_expiry(uint32_t now)
+{
+    uint32_t wait = NEOMESH_NO_DEADLINE;
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (!this->used[i] || !this->frames[i].has_deadline)
+            continue;
+        int32_t left = this->frames[i].deadline - now;
+        uint32_t ms = left > 0 ? left : 0;
+        if (ms < wait)
+            wait = ms;
+    }
+    return wait;
+}
+
+bool TxQueue::set_rate_limit(uint16_t node_id, uint16_t frames_per_minute, uint8_t burst)
+{
+    if (frames_per_minute == 0 && this->find_flow(node_id) == NEOMESH_NO_FLOW)
+        return true;    // No limit to remove. Do not take a flow entry for it
+
+    uint8_t i = this->get_flow(node_id);
+    if (i == NEOMESH_NO_FLOW)
+        return false;
+
+    tNcTxFlow * flow = &this->flows[i];
+    flow->adaptive = false;
+    flow->frames_per_minute = frames_per_minute;
+    flow->burst = burst != 0 ? burst : 1;
+    flow->tokens = flow->burst * NEOMESH_TOKENS_PER_FRAME;
+    flow->last_refill = millis();
+    if (flow->backlog == 0)
+        this->release_flow(i);
+    return true;
+}
+
+uint16_t TxQueue::get_rate_limit(uint16_t node_id)
+{
+    uint8_t i = this->find_flow(node_id);
+    return i != NEOMESH_NO_FLOW ? this->flows[i].frames_per_minute : 0;
+}
+
+void TxQueue::enable_congestion_control(uint16_t initial_fpm, uint16_t min_fpm, uint16_t max_fpm)
+{
+    this->cc_min = min_fpm != 0 ? min_fpm : 1;
+    this->cc_max = max_fpm > this->cc_min ? max_fpm : this->cc_min;
+    this->cc_initial = initial_fpm < this->cc_min ? this->cc_min : (initial_fpm > this->cc_max ? this->cc_max : initial_fpm);
+    this->cc_enabled = true;
+}
+
+void TxQueue::disable_congestion_control()
+{
+    this->cc_enabled = false;
+    for (int i = 0; i < NEOMESH_MAX_FLOWS; i++)
+    {
+        if (this->flows[i].node_id == 0 || !this->flows[i].adaptive)
+            continue;
+        this->flows[i].adaptive = false;
+        this->flows[i].frames_per_minute = 0;
+        if (this->flows[i].backlog == 0)
+            this->release_flow(i);
+    }
+}
+
+void TxQueue::congestion_feedback(uint16_t node_id, bool congested)
+{
+    if (!this->cc_enabled || node_id == 0)
+        return;
+
+    for (int i = 0; i < NEOMESH_MAX_FLOWS; i++)
+    {
+        tNcTxFlow * flow = &this->flows[i];
+        if (flow->node_id != node_id || !flow->adaptive)
+            continue;
+
+        // Additive increase, multiplicative decrease
+        uint32_t fpm = flow->frames_per_minute;
+        if (congested)
+            fpm /= 2;
+        else
+            fpm += NEOMESH_AIMD_INCREASE;
+        if (fpm < this->cc_min)
+            fpm = this->cc_min;
+        if (fpm > this->cc_max)
+            fpm = this->cc_max;
+        flow->frames_per_minute = fpm;
+        return;
+    }
+}
+
+/*******************************************************************************
+ *    Private Class/Functions
+ ******************************************************************************/
+
+bool TxQueue::higher_priority_waiting(uint8_t priority)
+{
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (this->used[i] && this->frames[i].priority < priority)
+            return true;
+    }
+    return false;
+}
+
+bool TxQueue::lower_priority_waiting(uint8_t priority)
+{
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (this->used[i] && this->frames[i].priority > priority)
+            return true;
+    }
+    return false;
+}
+
+uint8_t TxQueue::find_flow(uint16_t node_id)
+{
+    for (int i = 0; i < NEOMESH_MAX_FLOWS; i++)
+    {
+        if (this->flows[i].node_id == node_id)
+            return i;
+    }
+    return NEOMESH_NO_FLOW;
+}
+
+uint8_t TxQueue::get_flow(uint16_t node_id)
+{
+    uint8_t free_flow = NEOMESH_NO_FLOW;
+    for (int i = 0; i < NEOMESH_MAX_FLOWS; i++)
+    {
+        if (this->flows[i].node_id == node_id)
+            return i;
+        if (this->flows[i].node_id == 0 && free_flow == NEOMESH_NO_FLOW)
+            free_flow = i;
+    }
+
+    if (free_flow == NEOMESH_NO_FLOW)
+    {
+        // Forget the learned rate of an idle destination before refusing a new one
+        for (int i = 0; i < NEOMESH_MAX_FLOWS; i++)
+        {
+            if (this->flows[i].adaptive && this->flows[i].backlog == 0)
+            {
+                free_flow = i;
+                break;
+            }
+        }
+    }
+
+    if (free_flow != NEOMESH_NO_FLOW)
+    {
+        memset(&this->flows[free_flow], 0, sizeof(tNcTxFlow));
+        this->flows[free_flow].node_id = node_id;
+    }
+    return free_flow;
+}
+
+void TxQueue::release_flow(uint8_t flow)
+{
+    // A destination starts every busy period with an empty deficit
+    this->flows[flow].deficit = 0;
+    if (this->flows[flow].frames_per_minute == 0)
+        this->flows[flow].node_id = 0;  // Nothing to remember
+}
+
+void TxQueue::refill_tokens()
+{
+    uint32_t now = millis();
+    for (int i = 0; i < NEOMESH_MAX_FLOWS; i++)
+    {
+        tNcTxFlow * flow = &this->flows[i];
+        if (flow->node_id == 0 || flow->frames_per_minute == 0)
+            continue;
+
+        uint32_t elapsed = now - flow->last_refill;
+        if (elapsed > 60000)
+            elapsed = 60000;    // Keeps the multiplication below within 32 bits
+        uint32_t max_tokens = flow->burst * NEOMESH_TOKENS_PER_FRAME;
+        flow->tokens += flow->frames_per_minute * elapsed;
+        if (flow->tokens > max_tokens)
+            flow->tokens = max_tokens;
+        flow->last_refill = now;
+    }
+}
+
+bool TxQueue::flow_allowed(uint8_t flow)
+{
+    if (flow == NEOMESH_NO_FLOW)
+        return true;
+    return this->flows[flow].frames_per_minute == 0 || this->flows[flow].tokens >= NEOMESH_TOKENS_PER_FRAME;
+}
+
+bool TxQueue::eligible(tNcTxFrame * frame)
+{
+    return frame->priority < this->priority_limit && this->flow_allowed(frame->flow);
+}
+
+tNcTxFrame * TxQueue::oldest_eligible(uint8_t priority, uint8_t flow)
+{
+    tNcTxFrame * oldest = nullptr;
+    for (int i = 0; i < NEOMESH_TX_QUEUE_SIZE; i++)
+    {
+        if (!this->used[i])
+            continue;
+        tNcTxFrame * f = &this->frames[i];
+        if (f->priority != priority || f->flow != flow || !this->eligible(f))
+            continue;
+        if (oldest == nullptr || (int32_t)(f->ticket - oldest->ticket) < 0)
+            oldest = f;
+    }
+    return oldest;
+}
+
+tNcTxFrame * TxQueue::select(uint8_t priority)
+{
+    if (priority == NEOMESH_PRIORITY_CONTROL)
+        return this->oldest_eligible(priority, NEOMESH_NO_FLOW);
+
+    // Deficit round robin. Every visit to a destination adds a quantum to its deficit, and the
+    // destination keeps sending while its next frame fits within the deficit
+    for (int step = 0; step <= 2 * NEOMESH_MAX_FLOWS; step++)
+    {
+        tNcTxFlow * flow = &this->flows[this->drr_cursor];
+        tNcTxFrame * f = nullptr;
+        if (flow->node_id != 0)
+            f = this->oldest_eligible(priority, this->drr_cursor);
+
+        if (f != nullptr)
+        {
+            if (!this->drr_visited)
+            {
+                flow->deficit += NEOMESH_DRR_QUANTUM;
+                this->drr_visited = true;
+            }
+            if (f->length <= flow->deficit)
+                return f;
+        }
+
+        this->drr_cursor = (this->drr_cursor + 1) % NEOMESH_MAX_FLOWS;
+        this->drr_visited = false;
+    }
+    return nullptr;
+}
+
+/*******************************************************************************/
+
+/** @} addtogroup end */
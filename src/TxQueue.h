@@ -0,0 +1,276 @@
+/*******************************************************************************
+ * @file TxQueue.h
+ * @date 2026-10-19
+ * @author agent (agent@local)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *******************************************************************************/
+
+/**
+ * @addtogroup NeoMesh
+ * @{
+ */
+
+#ifndef TX_QUEUE_H
+#define TX_QUEUE_H
+
+/*******************************************************************************
+ *    Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "NcApi.h"
+
+/*******************************************************************************
+ *    Defines
+ ******************************************************************************/
+
+#ifndef NEOMESH_TX_QUEUE_SIZE
+#define NEOMESH_TX_QUEUE_SIZE 8     //!< Number of frames that can wait for the NcApi TX slot
+#endif
+
+#ifndef NEOMESH_MAX_FLOWS
+#define NEOMESH_MAX_FLOWS NEOMESH_TX_QUEUE_SIZE   //!< Number of destinations that can have frames queued or a rate limit set
+#endif
+
+#ifndef NEOMESH_DRR_QUANTUM
+#define NEOMESH_DRR_QUANTUM NCAPI_TXBUFFER_SIZE     //!< Bytes a destination may send per deficit round robin round
+#endif
+
+#ifndef NEOMESH_AIMD_INCREASE
+#define NEOMESH_AIMD_INCREASE 2     //!< Frames per minute added to a destination's rate for every delivered frame
+#endif
+
+#ifndef NEOMESH_AIMD_BURST
+#define NEOMESH_AIMD_BURST 2        //!< Burst of destinations whose rate is set by congestion control
+#endif
+
+// NcApi writes an unacknowledged frame as 7 header bytes plus payload into its TX buffer, so
+// payloads longer than this would overflow it, even if NCAPI_MAX_PAYLOAD_LENGTH allows them
+#define NEOMESH_UNACK_HEADER_LENGTH 7
+#define NEOMESH_MAX_UNACK_PAYLOAD_LENGTH (NCAPI_TXBUFFER_SIZE - NEOMESH_UNACK_HEADER_LENGTH < NCAPI_MAX_PAYLOAD_LENGTH \
+    ? NCAPI_TXBUFFER_SIZE - NEOMESH_UNACK_HEADER_LENGTH : NCAPI_MAX_PAYLOAD_LENGTH)
+
+// Longest frame written for the radio, acknowledged or unacknowledged, including its 2 byte prefix
+#define NEOMESH_ACK_HEADER_LENGTH 5
+#define NEOMESH_MAX_FRAME_LENGTH (NEOMESH_ACK_HEADER_LENGTH + NCAPI_MAX_PAYLOAD_LENGTH > NEOMESH_UNACK_HEADER_LENGTH + NEOMESH_MAX_UNACK_PAYLOAD_LENGTH \
+    ? NEOMESH_ACK_HEADER_LENGTH + NCAPI_MAX_PAYLOAD_LENGTH : NEOMESH_UNACK_HEADER_LENGTH + NEOMESH_MAX_UNACK_PAYLOAD_LENGTH)
+
+#define NEOMESH_TOKENS_PER_FRAME 60000UL    // Token bucket resolution. One frame per minute refills one token per ms
+#define NEOMESH_NO_FLOW 0xff
+#define NEOMESH_NO_DEADLINE 0xffffffffUL    // Returned as time to the next event when there is none
+
+#ifndef NEOMESH_PRIORITY_BURST
+#define NEOMESH_PRIORITY_BURST 4    //!< Frames sent ahead of a waiting lower priority frame before it gets a turn
+#endif
+
+/*******************************************************************************
+ *    Type defines
+ ******************************************************************************/
+
+/**
+* @brief Priority of an outgoing frame. Lower value is sent first
+*/
+typedef enum {
+    /**
+    * @brief Commissioning and network commands
+    */
+    NEOMESH_PRIORITY_CONTROL = 0,
+
+    /**
+    * @brief Application data
+    */
+    NEOMESH_PRIORITY_NORMAL = 1,
+
+    /**
+    * @brief Bulk data that may wait for everything else
+    */
+    NEOMESH_PRIORITY_BULK = 2,
+
+    NEOMESH_PRIORITY_COUNT
+} tNcPriority;
+
+/**
+* @brief A frame waiting to be handed to NcApi
+* @details type selects which of the parameter structs is valid. Payload pointers in the
+* parameters are set to point at payload when the frame is handed to NcApi
+*/
+typedef struct {
+    uint8_t type;       // NcApiMessageType
+    uint8_t priority;   // tNcPriority
+    uint16_t dest;      // Destination node id. 0 if the frame is for the attached module
+    uint8_t length;     // Number of bytes the frame takes on the UART
+    uint8_t flow;       // Set by TxQueue
+    uint32_t ticket;    // Set by TxQueue. Order in which the frame was queued
+    bool has_deadline;  // True if the frame should be dropped instead of sent after deadline
+    uint32_t deadline;  // millis() after which the frame is stale
+    union {
+        tNcApiSendUnackParams unack;
+        tNcApiSendAckParams ack;
+        tNcApiNetCmdParams net_cmd;
+        tNcApiWesCmdParams wes_cmd;
+        tNcApiWesResponseParams wes_response;
+        tNcApiNodeInfoParams node_info;
+    } params;
+    uint8_t payload[NCAPI_MAX_PAYLOAD_LENGTH];
+} tNcTxFrame;
+
+/**
+* @brief Per destination state used for fair queueing and rate limiting
+*/
+typedef struct {
+    uint16_t node_id;           // 0 if the entry is unused
+    uint8_t backlog;            // Frames queued for this destination
+    int16_t deficit;            // Bytes this destination may still send in the current round
+    uint16_t frames_per_minute; // Rate limit. 0 if the destination is not rate limited
+    uint8_t burst;              // Frames that may be sent back to back when the bucket is full
+    uint32_t tokens;            // NEOMESH_TOKENS_PER_FRAME per frame
+    uint32_t last_refill;       // millis() of last token refill
+    bool adaptive;              // True if frames_per_minute is set by congestion control
+} tNcTxFlow;
+
+/*******************************************************************************
+ *    Class prototypes
+ ******************************************************************************/
+/**
+* @brief Fixed size queue of outgoing frames, served in priority order
+* @details Control frames are served in the order they were queued. Data frames of the same
+* priority are served per destination in deficit round robin, so one busy destination can not
+* delay all others, and each destination can be given a token bucket rate limit.
+* A frame waiting behind higher priority traffic is sent after at most NEOMESH_PRIORITY_BURST
+* higher priority frames, so low priorities can not be starved
+*/
+class TxQueue
+{
+public:
+    /**
+    * @brief Copy a frame into the queue
+    * @param frame The frame to queue. dest and length must be set
+    * @return True if the frame was queued. False if the queue or the flow table is full
+    */
+    bool push(const tNcTxFrame * frame);
+
+    /**
+    * @brief Get the frame that should be sent next without removing it
+    * @details Must be followed by pop() of the returned frame, as it advances the round robin
+    * @param priority_limit Only consider frames with a lower priority value than this
+    * @return Pointer to the frame, or nullptr if no frame may be sent now
+    */
+    tNcTxFrame * peek(uint8_t priority_limit = NEOMESH_PRIORITY_COUNT);
+
+    /**
+    * @brief Remove a frame returned by peek()
+    * @param frame The frame to remove
+    */
+    void pop(tNcTxFrame * frame);
+
+    /**
+    * @brief Find a queued frame whose deadline has passed
+    * @param now Current millis()
+    * @return Pointer to the frame, or nullptr if no frame has expired. Remove it with remove()
+    */
+    tNcTxFrame * next_expired(uint32_t now);
+
+    /**
+    * @brief Remove a frame without sending it
+    * @param frame The frame to remove
+    */
+    void remove(tNcTxFrame * frame);
+
+    /**
+    * @brief See if a frame of a type is queued
+    * @param type NcApiMessageType
+    */
+    bool contains(uint8_t type);
+
+    /**
+    * @brief Get number of queued frames
+    */
+    uint8_t count();
+
+    /**
+    * @brief Get time until a frame may be sent
+    * @param now Current millis()
+    * @param priority_limit As for peek
+    * @return 0 if a frame may be sent now. NEOMESH_NO_DEADLINE if the queue is empty.
+    * Otherwise the time in ms until a rate limit lets the first frame go
+    */
+    uint32_t time_to_send(uint32_t now, uint8_t priority_limit = NEOMESH_PRIORITY_COUNT);
+
+    /**
+    * @brief Get time until the first queued frame expires
+    * @param now Current millis()
+    * @return Time in ms. NEOMESH_NO_DEADLINE if no queued frame has a deadline
+    */
+    uint32_t time_to_expiry(uint32_t now);
+
+    /**
+    * @brief Limit how often data frames are sent to a destination
+    * @param node_id The destination
+    * @param frames_per_minute Sustained rate. 0 removes the limit
+    * @param burst Number of frames that may be sent back to back after an idle period
+    * @return True if the limit was set, or removed from a destination that had none. False if the flow table is full
+    */
+    bool set_rate_limit(uint16_t node_id, uint16_t frames_per_minute, uint8_t burst);
+
+    /**
+    * @brief Get the current rate limit of a destination
+    * @return Frames per minute. 0 if the destination is not rate limited
+    */
+    uint16_t get_rate_limit(uint16_t node_id);
+
+    /**
+    * @brief Let delivery feedback set the rate limit of every destination without a fixed limit
+    * @details The rate is raised by NEOMESH_AIMD_INCREASE frames per minute for every delivered
+    * frame and halved for every NACK or dropped frame
+    * @param initial_fpm Rate a destination starts out with
+    * @param min_fpm Lowest rate
+    * @param max_fpm Highest rate
+    */
+    void enable_congestion_control(uint16_t initial_fpm, uint16_t min_fpm, uint16_t max_fpm);
+
+    /**
+    * @brief Stop congestion control and remove the rate limits it has set
+    */
+    void disable_congestion_control();
+
+    /**
+    * @brief Report the outcome of a frame sent to a destination
+    * @param node_id The destination
+    * @param congested True for NACK or dropped frames. False for delivered frames
+    */
+    void congestion_feedback(uint16_t node_id, bool congested);
+
+private:
+    tNcTxFrame frames[NEOMESH_TX_QUEUE_SIZE];
+    bool used[NEOMESH_TX_QUEUE_SIZE] = {false};
+    uint32_t next_ticket = 0;
+    uint8_t burst = 0;
+    uint8_t priority_limit = NEOMESH_PRIORITY_COUNT;    // Set by peek
+
+    tNcTxFlow flows[NEOMESH_MAX_FLOWS] = {};
+    uint8_t drr_cursor = 0;
+    bool drr_visited = false;
+
+    bool cc_enabled = false;
+    uint16_t cc_initial = 0;
+    uint16_t cc_min = 0;
+    uint16_t cc_max = 0;
+
+    bool higher_priority_waiting(uint8_t priority);
+    bool lower_priority_waiting(uint8_t priority);
+    uint8_t find_flow(uint16_t node_id);
+    uint8_t get_flow(uint16_t node_id);
+    void release_flow(uint8_t flow);
+    void refill_tokens();
+    bool flow_allowed(uint8_t flow);
+    bool eligible(tNcTxFrame * frame);
+    tNcTxFrame * oldest_eligible(uint8_t priority, uint8_t flow);
+    tNcTxFrame * select(uint8_t priority);
+};
+
+/*******************************************************************************/
+/** @} addtogroup end */
+
+#endif  // TX_QUEUE_H
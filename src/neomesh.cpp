@@ -19,6 +19,8 @@
 #include "NeoMesh.h"
 
 #include "SAPIParser.h"
+#include "NeoParser.h"
+#include "BulkTransfer.h"
 
 
 /*******************************************************************************
@@ -45,37 +47,55 @@ NeoMesh::NeoMesh(Stream * serial, uint8_t cts_pin)
     attachInterrupt(digitalPinToInterrupt(cts_pin), NeoMesh::pass_through_cts, FALLING);
 }
 
-void NeoMesh::start()
+NeoMesh::NeoMesh(HardwareSerial * serial, uint8_t cts_pin) : NeoMesh((Stream *) serial, cts_pin)
 {
-    //this->serial->begin(this->baudrate);
-
-    tNcApiRxHandlers *rxHandlers = &ncRx;
-    memset(rxHandlers, 0, sizeof(tNcApiRxHandlers));
-
-    rxHandlers->pfnReadCallback = NeoMesh::read_callback_;
-    rxHandlers->pfnHostAckCallback = NeoMesh::host_ack_callback_;
-    rxHandlers->pfnHostNAckCallback = NeoMesh::host_nack_callback_;
-    rxHandlers->pfnHostDataCallback = NeoMesh::host_data_callback_;
-    rxHandlers->pfnHostDataHapaCallback = NeoMesh::host_data_hapa_callback_;
-    rxHandlers->pfnWesSetupRequestCallback = NeoMesh::wes_setup_request_callback_;
-    rxHandlers->pfnWesStatusCallback = NeoMesh::wes_status_callback_;
+    this->hw_serial = serial;
+}
 
-    NcApiInit();
+void NeoMesh::start()
+{
+    this->started_at = millis();
+    this->ready = false;
+    this->time_to_ready = 0;
 
-    g_ncApi[this->uart_num].NcApiRxHandlers = &ncRx;
-    NcApiCallbackNwuActive(this->uart_num);
+    // Frames are dispatched by dispatch_all rather than NcApiExecuteCallbacks, so host data is
+    // only decoded into its NcApi struct if the callback for it is set
+    this->start_dispatch(NeoMesh::dispatch_all);
 }
 
-void NeoMesh::update()
+uint32_t NeoMesh::update()
 {
-    while (this->serial->available())
+    this->expire_frames();
+
+    for (;;)
     {
-        char c = this->serial->read();
+        this->handle_cts();
+        int byte = this->read_rx_byte();
+        if (byte < 0)
+            break;
+        char c = byte;
 
         // TODO: Find out which function should get c
         NcApiRxData(this->uart_num, c);
         this->sapi_parser.push_char(c);
     }
+
+    if (this->tx_write_msg != nullptr && this->continue_write())
+        NcApiTxDataDone(this->uart_num);
+
+    if (this->bulk != nullptr)
+        this->bulk->update();
+
+    this->pump_tx_queue();
+
+    return this->time_to_next_event();
+}
+
+bool NeoMesh::work_pending()
+{
+    return this->cts_head != this->cts_tail
+        || this->rx_ring_head != this->rx_ring_tail
+        || this->serial->available() > 0;
 }
 
 void NeoMesh::set_password(uint8_t new_password[5])
@@ -83,9 +103,66 @@ void NeoMesh::set_password(uint8_t new_password[5])
     strncpy((char *) this->password, (char *) new_password, 5);
 }
 
-void NeoMesh::write(uint8_t *finalMsg, uint8_t finalMsgLength)
+bool NeoMesh::write(uint8_t *finalMsg, uint8_t finalMsgLength)
+{
+    if (this->tx_write_msg != nullptr)
+        return false;   // CTS again while the frame is still being written
+
+    if (this->slot_frame_pending)
+    {
+        // The queued frame leaves NcApi now, so it can no longer expire
+        this->slot_frame_pending = false;
+        // Bulk transfers find lost fragments themselves and would take all tracking slots
+        if (this->slot_frame.type == CommandUnacknowledgedEnum
+            && (this->bulk == nullptr || this->slot_frame.params.unack.msg.destPort != this->bulk_port))
+            this->track_uapp(&this->slot_frame.params.unack.msg);
+        if (this->slot_frame.dest != 0)
+            this->airtime.record(millis(), finalMsgLength);   // Frames for the attached module do not go on air
+    }
+
+    this->tx_write_msg = finalMsg;
+    this->tx_write_length = finalMsgLength;
+    this->tx_write_done = 0;
+    this->tx_write_progress_at = millis();
+    return this->continue_write();
+}
+
+void NeoMesh::message_received(uint8_t *msg, uint8_t msgLength)
 {
-    this->serial->write(finalMsg, finalMsgLength);
+    if (!this->rx_filter.accept(msg, msgLength))
+        return;
+
+    // NcApi reuses its receive buffer for the next frame. Deliver the frame from a pool block
+    // instead, so the decoded messages stay valid if the application keeps the block
+    tNcRxFrame *frame = msgLength <= NEOMESH_RX_BLOCK_SIZE ? this->rx_pool.alloc() : nullptr;
+    if (frame != nullptr)
+    {
+        memcpy(frame->data, msg, msgLength);
+        frame->length = msgLength;
+        msg = frame->data;
+    }
+
+    this->rx_current = frame;
+    this->rx_taken = false;
+    if (this->rx_dispatch != 0)
+        this->rx_dispatch(this->uart_num, msg, msgLength);
+    this->rx_current = nullptr;
+    if (this->rx_taken)
+        return;
+
+    if (this->polling)
+    {
+        if (frame == nullptr)
+        {
+            this->poll_overflow++;
+            return;
+        }
+        // The pool has as many blocks as the queue has entries, so there is always room
+        this->poll_queue[(this->poll_head + this->poll_count) % NEOMESH_RX_POOL_SIZE] = frame;
+        this->poll_count++;
+        return;
+    }
+    this->rx_pool.release(frame);
 }
 
 void NeoMesh::change_node_id(uint16_t node_id)
@@ -112,58 +189,280 @@ void NeoMesh::set_baudrate(uint32_t baudrate)
     this->baudrate = baudrate;
 }
 
-void NeoMesh::send_unacknowledged(uint16_t destNodeId, uint8_t port, uint16_t appSeqNo, uint8_t *payload, uint8_t payloadLen)
+bool NeoMesh::begin_serial()
 {
-    tNcApiSendUnackParams args;
-    NcApiErrorCodes apiStatus;
-    args.msg.destNodeId = destNodeId;
-    args.msg.destPort = port;
-    args.msg.appSeqNo = appSeqNo;
-    args.msg.payload = payload;
-    args.msg.payloadLength = payloadLen;
-    args.callbackToken = &g_ncApi;
-    apiStatus = NcApiSendUnacknowledged(this->uart_num, &args);
-    if (apiStatus != NCAPI_OK)
+    if (this->hw_serial == nullptr)
+        return false;
+    this->hw_serial->begin(this->baudrate);
+    return true;
+}
+
+uint32_t NeoMesh::get_baudrate()
+{
+    return this->baudrate;
+}
+
+uint32_t NeoMesh::detect_baudrate()
+{
+    if (this->hw_serial == nullptr)
+        return 0;
+
+    if (this->probe_baudrate(this->baudrate))
+        return this->baudrate;
+
+    const uint32_t baudrates[] = NEOMESH_PROBE_BAUDRATES;
+    for (uint8_t i = 0; i < sizeof(baudrates) / sizeof(baudrates[0]); i++)
+    {
+        if (baudrates[i] != this->baudrate && this->probe_baudrate(baudrates[i]))
+        {
+            this->baudrate = baudrates[i];
+            return this->baudrate;
+        }
+    }
+
+    this->probe_baudrate(this->baudrate);   // Leave the UART at the configured rate
+    return 0;
+}
+
+bool NeoMesh::change_baudrate(uint32_t baudrate, uint8_t setting_value)
+{
+    if (this->hw_serial == nullptr || UART_BAUDRATE_SETTING == 0)
+        return false;
+
+    // The module restarts its protocol stack at the new rate when the setting is committed.
+    // If it was not, the module is still at the old rate, so only the receiver is resynced
+    if (!this->change_setting(UART_BAUDRATE_SETTING, &setting_value, 1))
     {
-        
+        this->probe_baudrate(this->baudrate);
+        return false;
     }
+    if (this->probe_baudrate(baudrate))
+    {
+        this->baudrate = baudrate;
+        return true;
+    }
+
+    this->probe_baudrate(this->baudrate);
+    return false;
 }
 
-void NeoMesh::send_acknowledged(uint16_t destNodeId, uint8_t port, uint8_t *payload, uint8_t payloadLen)
+NcApiErrorCodes NeoMesh::send_unacknowledged(uint16_t destNodeId, uint8_t port, uint16_t appSeqNo, uint8_t *payload, uint8_t payloadLen, uint8_t priority, uint32_t ttl_ms)
 {
-    tNcApiSendAckParams args;
-    NcApiErrorCodes apiStatus;
-    args.msg.destNodeId = destNodeId;
-    args.msg.destPort = port;
-    args.msg.payload = payload;
-    args.msg.payloadLength = payloadLen;
-    args.callbackToken = &g_ncApi;
-    apiStatus = NcApiSendAcknowledged(this->uart_num, &args);
+    NcApiErrorCodes apiStatus = this->check_payload_args(CommandUnacknowledgedEnum, destNodeId, port, payload, payloadLen);
     if (apiStatus != NCAPI_OK)
+        return apiStatus;
+
+    tNcTxFrame frame;
+    frame.type = CommandUnacknowledgedEnum;
+    frame.priority = priority;
+    frame.dest = destNodeId;
+    frame.length = 7 + payloadLen;
+    frame.params.unack.msg.destNodeId = destNodeId;
+    frame.params.unack.msg.destPort = port;
+    frame.params.unack.msg.appSeqNo = appSeqNo & NCAPI_APPSEQNO_MASK;
+    frame.params.unack.msg.payloadLength = payloadLen;
+    frame.params.unack.callbackToken = &g_ncApi;
+    if (payloadLen != 0)
+        memcpy(frame.payload, payload, payloadLen);
+    return this->enqueue(&frame, ttl_ms);
+}
+
+NcApiErrorCodes NeoMesh::send_unacknowledged(uint16_t destNodeId, uint8_t port, uint8_t *payload, uint8_t payloadLen, uint16_t *appSeqNo, uint8_t priority, uint32_t ttl_ms)
+{
+    uint16_t *seq = this->get_app_seq_no(destNodeId);
+    NcApiErrorCodes apiStatus = this->send_unacknowledged(destNodeId, port, *seq, payload, payloadLen, priority, ttl_ms);
+    if (apiStatus != NCAPI_OK)
+        return apiStatus;
+
+    if (appSeqNo != nullptr)
+        *appSeqNo = *seq;
+    *seq = (*seq + 1) & NCAPI_APPSEQNO_MASK;
+    this->seq_shared_next = (this->seq_shared_next + 1) & NCAPI_APPSEQNO_MASK;
+    return apiStatus;
+}
+
+NcApiErrorCodes NeoMesh::send_acknowledged(uint16_t destNodeId, uint8_t port, uint8_t *payload, uint8_t payloadLen, uint8_t priority, uint32_t ttl_ms)
+{
+    NcApiErrorCodes apiStatus = this->check_payload_args(CommandAcknowledgedEnum, destNodeId, port, payload, payloadLen);
+    if (apiStatus != NCAPI_OK)
+        return apiStatus;
+
+    tNcTxFrame frame;
+    frame.type = CommandAcknowledgedEnum;
+    frame.priority = priority;
+    frame.dest = destNodeId;
+    frame.length = 5 + payloadLen;
+    frame.params.ack.msg.destNodeId = destNodeId;
+    frame.params.ack.msg.destPort = port;
+    frame.params.ack.msg.payloadLength = payloadLen;
+    frame.params.ack.callbackToken = &g_ncApi;
+    if (payloadLen != 0)
+        memcpy(frame.payload, payload, payloadLen);
+    return this->enqueue(&frame, ttl_ms);
+}
+
+NcApiErrorCodes NeoMesh::send_wes_command(NcApiWesCmdValues cmd)
+{
+    tNcTxFrame frame;
+    frame.type = WesCmdEnum;
+    frame.priority = NEOMESH_PRIORITY_CONTROL;
+    frame.dest = 0;
+    frame.length = 2 + NCAPI_WESCMD_LENGTH;
+    frame.params.wes_cmd.msg.cmd = cmd;
+    frame.params.wes_cmd.callbackToken = &g_ncApi;
+    return this->enqueue(&frame);
+}
+
+NcApiErrorCodes NeoMesh::send_wes_respond(uint64_t uid, uint16_t nodeId)
+{
+    tNcTxFrame frame;
+    frame.type = WesResponseEnum;
+    frame.priority = NEOMESH_PRIORITY_CONTROL;
+    frame.dest = 0;
+    frame.length = 2 + NCAPI_WESRESPONSE_LENGTH;
+    tNcApiWesResponseParams *args = &frame.params.wes_response;
+    memset(args, 0, sizeof(tNcApiWesResponseParams));
+    args->msg.uid[0] = (uid >> 32) & 0xff;
+    args->msg.uid[1] = (uid >> 24) & 0xff;
+    args->msg.uid[2] = (uid >> 16) & 0xff;
+    args->msg.uid[3] = (uid >> 8) & 0xff;
+    args->msg.uid[4] = uid & 0xff;
+    args->msg.nodeId = nodeId;
+    args->callbackToken = &g_ncApi;
+    return this->enqueue(&frame);
+}
+
+NcApiErrorCodes NeoMesh::send_net_cmd(uint16_t destNodeId, NcApiNetCmdValues cmd, uint8_t *payload, uint8_t payloadLen)
+{
+    if (payloadLen > NCAPI_MAX_PAYLOAD_LENGTH) return NCAPI_ERR_PAYLOAD;
+    if (payloadLen != 0 && payload == 0) return NCAPI_ERR_NULLPAYLOAD;
+
+    tNcTxFrame frame;
+    frame.type = NetCmdEnum;
+    frame.priority = NEOMESH_PRIORITY_CONTROL;
+    frame.dest = destNodeId;
+    frame.length = 5 + payloadLen;
+    frame.params.net_cmd.msg.destNodeId = destNodeId;
+    frame.params.net_cmd.msg.cmd = cmd;
+    frame.params.net_cmd.msg.payloadLength = payloadLen;
+    frame.params.net_cmd.callbackToken = &g_ncApi;
+    if (payloadLen != 0)
+        memcpy(frame.payload, payload, payloadLen);
+    return this->enqueue(&frame);
+}
+
+NcApiErrorCodes NeoMesh::send_node_info_request()
+{
+    tNcTxFrame frame;
+    frame.type = NodeInfoRequestEnum;
+    frame.priority = NEOMESH_PRIORITY_CONTROL;
+    frame.dest = 0;
+    frame.length = 2 + NCAPI_NODEINFOREQUEST_LENGTH;
+    frame.params.node_info.msg.dummy = 0;
+    frame.params.node_info.callbackToken = &g_ncApi;
+    return this->enqueue(&frame);
+}
+
+bool NeoMesh::node_info_request_pending()
+{
+    if (this->slot_frame_pending && this->slot_frame.type == NodeInfoRequestEnum)
+        return true;
+    return this->tx_queue.contains(NodeInfoRequestEnum);
+}
+
+bool NeoMesh::wait_ready(uint32_t timeout_ms)
+{
+    if (this->ready)
+        return true;
+
+    // A request from an earlier call that timed out may still be waiting for CTS. One that was
+    // written already may have had its reply lost, so it is sent again
+    uint32_t waiting_since = millis();
+    if (!this->node_info_request_pending() && this->send_node_info_request() != NCAPI_OK)
+        return false;
+
+    while (!this->ready)
     {
-        // TODO: Tell application something went wrong. Maybe map error codes to error strings
+        if (millis() - waiting_since >= timeout_ms)
+            return false;
+        this->update();
     }
+    return true;
+}
+
+bool NeoMesh::is_ready()
+{
+    return this->ready;
+}
+
+uint32_t NeoMesh::get_time_to_ready()
+{
+    return this->time_to_ready;
+}
+
+uint16_t NeoMesh::get_node_id()
+{
+    return this->node_info.nodeId;
+}
+
+tNcApiNodeInfoReply NeoMesh::get_node_info()
+{
+    return this->node_info;
+}
+
+uint8_t NeoMesh::get_tx_queue_count()
+{
+    return this->tx_queue.count();
+}
+
+tNcTxStats NeoMesh::get_tx_stats()
+{
+    return this->tx_stats;
+}
+
+void NeoMesh::set_airtime_budget(uint32_t budget_ms, uint32_t window_ms)
+{
+    this->airtime.set_budget(budget_ms, window_ms);
+}
+
+void NeoMesh::set_airtime_model(uint16_t frame_us, uint16_t byte_us)
+{
+    this->airtime.set_model(frame_us, byte_us);
+}
+
+uint32_t NeoMesh::get_airtime_used()
+{
+    return this->airtime.get_used(millis());
+}
+
+tNcAirtimeStats NeoMesh::get_airtime_stats()
+{
+    return this->airtime.get_stats();
+}
+
+bool NeoMesh::set_rate_limit(uint16_t destNodeId, uint16_t frames_per_minute, uint8_t burst)
+{
+    return this->tx_queue.set_rate_limit(destNodeId, frames_per_minute, burst);
 }
 
-void NeoMesh::send_wes_command(NcApiWesCmdValues cmd)
+bool NeoMesh::clear_rate_limit(uint16_t destNodeId)
 {
-    tNcApiWesCmdParams args;
-    args.msg.cmd = cmd;
-    args.callbackToken = &g_ncApi;
-    NcApiSendWesCmd(this->uart_num, &args);
+    return this->tx_queue.set_rate_limit(destNodeId, 0, 0);
 }
 
-void NeoMesh::send_wes_respond(uint64_t uid, uint16_t nodeId)
+uint16_t NeoMesh::get_rate_limit(uint16_t destNodeId)
 {
-    tNcApiWesResponseParams args;
-    args.msg.uid[0] = (uid >> 32) & 0xff;
-    args.msg.uid[1] = (uid >> 24) & 0xff;
-    args.msg.uid[2] = (uid >> 16) & 0xff;
-    args.msg.uid[3] = (uid >> 8) & 0xff;
-    args.msg.uid[4] = uid & 0xff;
-    args.msg.nodeId = nodeId;
-    args.callbackToken = &g_ncApi;
-    NcApiSendWesResponse(this->uart_num, &args);
+    return this->tx_queue.get_rate_limit(destNodeId);
+}
+
+void NeoMesh::enable_congestion_control(uint16_t initial_fpm, uint16_t min_fpm, uint16_t max_fpm)
+{
+    this->tx_queue.enable_congestion_control(initial_fpm, min_fpm, max_fpm);
+}
+
+void NeoMesh::disable_congestion_control()
+{
+    this->tx_queue.disable_congestion_control();
 }
 
 bool NeoMesh::change_setting(uint8_t setting, uint8_t * value, uint8_t length)
@@ -199,6 +498,7 @@ bool NeoMesh::switch_sapi_aapi()
 {
     tNcSapiMessage message;
     uint8_t cmd = 0x0B;
+    this->module_mode = SAPI_LOGGED_OUT;    // Hold back queued frames while switching
     this->write_raw(&cmd, 1);
     bool response = this->wait_for_sapi_response(&message, 250);
     bool success = response && message.command == BootloaderStarted;
@@ -227,6 +527,7 @@ void NeoMesh::start_bootloader()
 void NeoMesh::start_protocol_stack()
 {
     this->write_sapi_command(SAPI_COMMAND_START_PROTOCOL1, SAPI_COMMAND_START_PROTOCOL2, nullptr, 0);
+    this->module_mode = AAPI;
 }
 
 bool NeoMesh::get_setting(uint8_t setting, NcSetting * setting_ret)
@@ -304,9 +605,11 @@ void NeoMesh::write_raw(uint8_t *data, uint8_t length)
 
 bool NeoMesh::wait_for_sapi_response(tNcSapiMessage * message, uint32_t timeout_ms)
 {
-    // TODO: Return false after timeout
+    uint32_t waiting_since = millis();
     while(!this->sapi_parser.message_available())
     {
+        if (millis() - waiting_since >= timeout_ms)
+            return false;
         this->update();
     }
     *message = this->sapi_parser.get_pending_message();
@@ -318,11 +621,727 @@ tNcModuleMode NeoMesh::get_module_mode()
     return this->module_mode;
 }
 
+tNcUappStats NeoMesh::get_uapp_stats()
+{
+    return this->uapp_stats;
+}
+
+uint8_t NeoMesh::get_outstanding_uapp_count()
+{
+    uint8_t count = 0;
+    for (int i = 0; i < NEOMESH_UAPP_TRACKING_SIZE; i++)
+    {
+        if (this->uapp_frame_used[i])
+            count++;
+    }
+    return count;
+}
+
+bool NeoMesh::attach_bulk_transfer(BulkTransfer * bulk)
+{
+    if (this->bulk != nullptr && this->bulk != bulk)
+        return false;
+    this->bulk = bulk;
+    this->bulk_port = bulk->get_port();
+    return true;
+}
+
+void NeoMesh::set_rx_buffer(uint8_t * buffer, uint16_t size)
+{
+    noInterrupts();
+    this->rx_ring_head = 0;
+    this->rx_ring_tail = 0;
+    this->rx_ring_size = size > 256 ? 256 : size;
+    this->rx_ring = this->rx_ring_size >= 2 ? buffer : nullptr;
+    interrupts();
+}
+
+void NeoMesh::drain_serial()
+{
+    // Guard against being interrupted by a drain from an interrupt, so there is only one producer
+    if (this->rx_ring == nullptr || this->rx_draining)
+        return;
+    this->rx_draining = true;
+
+    while (this->serial->available())
+    {
+        // The CTS interrupt must see the byte either in serial or in the ring
+        noInterrupts();
+        uint8_t c = this->serial->read();
+        uint8_t head = this->rx_ring_head;
+        uint8_t next = ((uint16_t)head + 1) % this->rx_ring_size;
+        if (next == this->rx_ring_tail)
+        {
+            // Ring is full. Remember where the gap is, so the parser can be resynced there
+            uint16_t position = this->rx_consumed + this->rx_ring_count();
+            this->rx_overflow++;
+            if (!this->rx_lost)
+            {
+                this->rx_lost_position = position;
+                this->rx_lost = true;
+            }
+            // Edges queued while the byte was waiting in serial counted it. Only kept bytes are consumed
+            for (uint8_t i = this->cts_tail; i != this->cts_head; i++)
+            {
+                if ((int16_t)(this->cts_positions[i % NEOMESH_CTS_QUEUE_SIZE] - position) > 0)
+                    this->cts_positions[i % NEOMESH_CTS_QUEUE_SIZE]--;
+            }
+            interrupts();
+            continue;
+        }
+        this->rx_ring[head] = c;
+        this->rx_ring_head = next;
+        interrupts();
+    }
+
+    this->rx_draining = false;
+}
+
+uint32_t NeoMesh::get_rx_overflow_count()
+{
+    noInterrupts();
+    uint32_t count = this->rx_overflow;
+    interrupts();
+    return count;
+}
+
+uint16_t NeoMesh::get_cts_overflow_count()
+{
+    noInterrupts();
+    uint16_t count = this->cts_overflow;
+    interrupts();
+    return count;
+}
+
+tNcRxFrame * NeoMesh::take_rx_frame()
+{
+    if (this->rx_current == nullptr)
+        return nullptr;
+    this->rx_taken = true;
+    return this->rx_current;
+}
+
+void NeoMesh::release_rx_frame(tNcRxFrame * frame)
+{
+    this->rx_pool.release(frame);
+}
+
+uint8_t NeoMesh::get_free_rx_frames()
+{
+    return this->rx_pool.available();
+}
+
+void NeoMesh::enable_polling()
+{
+    this->polling = true;
+}
+
+void NeoMesh::disable_polling()
+{
+    this->polling = false;
+    while (this->poll_count != 0)
+    {
+        this->rx_pool.release(this->poll_queue[this->poll_head]);
+        this->poll_head = (this->poll_head + 1) % NEOMESH_RX_POOL_SIZE;
+        this->poll_count--;
+    }
+}
+
+tNcRxFrame * NeoMesh::poll_frame()
+{
+    if (this->poll_count == 0)
+        return nullptr;
+
+    tNcRxFrame *frame = this->poll_queue[this->poll_head];
+    this->poll_head = (this->poll_head + 1) % NEOMESH_RX_POOL_SIZE;
+    this->poll_count--;
+    return frame;
+}
+
+bool NeoMesh::poll(tNcMessage * message)
+{
+    tNcRxFrame *frame = this->poll_frame();
+    if (frame == nullptr)
+        return false;
+
+    message->length = frame->length;
+    memcpy(message->raw, frame->data, frame->length);
+    this->rx_pool.release(frame);
+    NeoMesh::decode_message(message);
+    return true;
+}
+
+uint8_t NeoMesh::poll_batch(tNcMessage * messages, uint8_t count)
+{
+    uint8_t i = 0;
+    while (i < count && this->poll(&messages[i]))
+        i++;
+    return i;
+}
+
+uint32_t NeoMesh::get_poll_overflow_count()
+{
+    return this->poll_overflow;
+}
+
+bool NeoMesh::register_port_handler(uint8_t type, uint8_t port, NeoMeshPortHandler handler, uint16_t originId)
+{
+    if (port >= NEOMESH_PORT_COUNT)
+        return false;
+    if (type == NEOMESH_ALL_HOST_DATA)
+    {
+        for (int i = 0; i < NEOMESH_HOST_DATA_TYPES; i++)
+            this->register_port_handler(HostDataEnum + i, port, handler, originId);
+        return true;
+    }
+    if (type < HostDataEnum || type >= HostDataEnum + NEOMESH_HOST_DATA_TYPES)
+        return false;
+
+    this->port_handlers[type - HostDataEnum][port] = handler;
+    this->port_handler_origins[type - HostDataEnum][port] = originId;
+    return true;
+}
+
+void NeoMesh::unregister_port_handler(uint8_t type, uint8_t port)
+{
+    this->register_port_handler(type, port, 0, 0);
+}
+
+void NeoMesh::set_rx_type_filter(uint8_t type, bool enabled)
+{
+    this->rx_filter.set_type(type, enabled);
+}
+
+void NeoMesh::set_rx_port_filter(uint8_t port_mask)
+{
+    this->rx_filter.set_ports(port_mask);
+}
+
+void NeoMesh::set_rx_origin_filter_mode(tNcOriginFilterMode mode)
+{
+    this->rx_filter.set_origin_mode(mode);
+}
+
+bool NeoMesh::add_rx_origin_filter(uint16_t originId)
+{
+    return this->rx_filter.add_origin(originId);
+}
+
+void NeoMesh::remove_rx_origin_filter(uint16_t originId)
+{
+    this->rx_filter.remove_origin(originId);
+}
+
+uint32_t NeoMesh::get_rx_filtered_count()
+{
+    return this->rx_filter.get_dropped_count();
+}
 
 /*******************************************************************************
  *    Private Class/Functions
  ******************************************************************************/
 
+NcApiErrorCodes NeoMesh::check_payload_args(uint8_t type, uint16_t destNodeId, uint8_t port, uint8_t *payload, uint8_t payloadLen)
+{
+    // Same checks as NcApi does, so errors are reported when the frame is queued. Unacknowledged
+    // payloads are also checked against the TX buffer, which NcApi does not do
+    if (destNodeId == 0) return NCAPI_ERR_NODEID;
+    if (port > 4) return NCAPI_ERR_DESTPORT;
+    if (payloadLen > NCAPI_MAX_PAYLOAD_LENGTH) return NCAPI_ERR_PAYLOAD;
+    if (type == CommandUnacknowledgedEnum && payloadLen > NEOMESH_MAX_UNACK_PAYLOAD_LENGTH) return NCAPI_ERR_PAYLOAD;
+    if (payloadLen != 0 && payload == 0) return NCAPI_ERR_NULLPAYLOAD;
+    return NCAPI_OK;
+}
+
+NcApiErrorCodes NeoMesh::enqueue(tNcTxFrame *frame, uint32_t ttl_ms)
+{
+    frame->has_deadline = ttl_ms != 0;
+    frame->deadline = millis() + ttl_ms;
+    if (!this->tx_queue.push(frame))
+        return NCAPI_ERR_ENQUEUED;
+    this->tx_stats.queued++;
+    this->pump_tx_queue();
+    return NCAPI_OK;
+}
+
+void NeoMesh::pump_tx_queue()
+{
+    this->expire_frames();
+
+    // Frames are only handed to NcApi in application mode and when its single TX slot is free
+    while (this->module_mode == AAPI && NcApiStatus(this->uart_num) == NCAPI_OK)
+    {
+        tNcTxFrame *frame = this->tx_queue.peek(this->airtime_priority_limit(millis()));
+        if (frame == nullptr)
+            return;
+
+        // Remember the frame before NcApi sees it, as the next CTS writes it out
+        this->slot_frame = *frame;
+        if (frame->type == CommandUnacknowledgedEnum)
+            this->slot_frame.params.unack.msg.payload = this->slot_frame.payload;
+        this->slot_frame_pending = true;
+        if (this->dispatch(frame) == NCAPI_OK)
+            this->tx_stats.dispatched++;
+        else
+            this->slot_frame_pending = false;
+        this->tx_queue.pop(frame);
+    }
+}
+
+void NeoMesh::expire_frames()
+{
+    uint32_t now = millis();
+    tNcTxFrame *frame;
+    while ((frame = this->tx_queue.next_expired(now)) != nullptr)
+    {
+        tNcTxFrame expired = *frame;
+        this->tx_queue.remove(frame);
+        this->frame_expired(&expired);
+    }
+
+    if (!this->slot_frame_pending || !this->slot_frame.has_deadline || (int32_t)(now - this->slot_frame.deadline) < 0)
+        return;
+
+    // The frame is still waiting in NcApi for CTS, e.g. because the module is rebooting.
+    // CTS is handled from update(), so the frame can not be written while it is cancelled
+    NcApiCancelEnqueuedMessage(this->uart_num);
+    this->slot_frame_pending = false;
+    this->frame_expired(&this->slot_frame);
+}
+
+void NeoMesh::frame_expired(tNcTxFrame *frame)
+{
+    this->tx_stats.expired++;
+    if (this->tx_expired_callback != 0)
+        this->tx_expired_callback(frame);
+}
+
+NcApiErrorCodes NeoMesh::dispatch(tNcTxFrame *frame)
+{
+    NcApiErrorCodes apiStatus = NCAPI_ERR_NOARGS;
+    switch (frame->type)
+    {
+        case CommandUnacknowledgedEnum:
+            frame->params.unack.msg.payload = frame->payload;
+            apiStatus = NcApiSendUnacknowledged(this->uart_num, &frame->params.unack);
+            break;
+        case CommandAcknowledgedEnum:
+            frame->params.ack.msg.payload = frame->payload;
+            apiStatus = NcApiSendAcknowledged(this->uart_num, &frame->params.ack);
+            break;
+        case NetCmdEnum:
+            frame->params.net_cmd.msg.payload = frame->payload;
+            apiStatus = NcApiSendNetCmd(this->uart_num, &frame->params.net_cmd);
+            break;
+        case WesCmdEnum:
+            apiStatus = NcApiSendWesCmd(this->uart_num, &frame->params.wes_cmd);
+            break;
+        case WesResponseEnum:
+            apiStatus = NcApiSendWesResponse(this->uart_num, &frame->params.wes_response);
+            break;
+        case NodeInfoRequestEnum:
+            apiStatus = NcApiSendNodeInfoRequest(this->uart_num, &frame->params.node_info);
+            break;
+    }
+    return apiStatus;
+}
+
+uint16_t *NeoMesh::get_app_seq_no(uint16_t destNodeId)
+{
+    // The table is kept with the most recently used destination first. Node id 0 is never a
+    // valid destination, so it marks the unused slots at the end
+    int i = 0;
+    while (i < NEOMESH_MAX_DESTINATIONS - 1 && this->seq_node_ids[i] != destNodeId && this->seq_node_ids[i] != 0)
+        i++;
+
+    // A destination that is new, or replaces the least recently used one, continues from the
+    // shared counter. It is never behind any destination's counter, so numbers are not reused soon
+    uint16_t next = this->seq_node_ids[i] == destNodeId ? this->seq_next[i] : this->seq_shared_next;
+    for (; i > 0; i--)
+    {
+        this->seq_node_ids[i] = this->seq_node_ids[i - 1];
+        this->seq_next[i] = this->seq_next[i - 1];
+    }
+    this->seq_node_ids[0] = destNodeId;
+    this->seq_next[0] = next;
+    return &this->seq_next[0];
+}
+
+void NeoMesh::track_uapp(tNcApiSendUnackMessage *msg)
+{
+    int slot = -1;
+    for (int i = 0; i < NEOMESH_UAPP_TRACKING_SIZE; i++)
+    {
+        if (!this->uapp_frame_used[i])
+        {
+            slot = i;
+            break;
+        }
+        if (slot < 0 || (int32_t)(this->uapp_frame_ticket[i] - this->uapp_frame_ticket[slot]) < 0)
+            slot = i;
+    }
+
+    if (this->uapp_frame_used[slot])
+        this->uapp_stats.evicted++;    // Oldest frame gave up its slot
+
+    tNcUappFrame *frame = &this->uapp_frames[slot];
+    frame->destNodeId = msg->destNodeId;
+    frame->port = msg->destPort;
+    frame->appSeqNo = msg->appSeqNo;
+    frame->sent_at = millis();
+    frame->payloadLength = msg->payloadLength;
+    if (msg->payloadLength != 0)
+        memcpy(frame->payload, msg->payload, msg->payloadLength);
+    this->uapp_frame_used[slot] = true;
+    this->uapp_frame_ticket[slot] = this->uapp_stats.sent++;
+}
+
+void NeoMesh::resolve_uapp(tNcApiHostUappStatus *m, bool dropped)
+{
+    uint16_t appSeqNo = m->appSeqNo & NCAPI_APPSEQNO_MASK;
+    for (int i = 0; i < NEOMESH_UAPP_TRACKING_SIZE; i++)
+    {
+        tNcUappFrame *frame = &this->uapp_frames[i];
+        if (!this->uapp_frame_used[i] || frame->destNodeId != m->originId || frame->appSeqNo != appSeqNo)
+            continue;
+
+        // Free the slot before calling back, so the application can re-queue the frame
+        tNcUappFrame copy = *frame;
+        this->uapp_frame_used[i] = false;
+        if (dropped)
+            this->uapp_stats.dropped++;
+        else
+            this->uapp_stats.confirmed++;
+
+        if (this->uapp_outcome_callback != 0)
+            this->uapp_outcome_callback(&copy, dropped);
+        return;
+    }
+    this->uapp_stats.untracked++;
+}
+
+void NeoMesh::decode_message(tNcMessage *message)
+{
+    uint8_t *raw = message->raw;
+    message->type = raw[0];
+    switch (message->type)
+    {
+        case HostAckEnum:
+        case HostNAckEnum:
+            NcApiGetMsgAsHostAck(raw, &message->msg.ack);
+            break;
+        case HostUappDataSend:
+        case HostUappDataDropped:
+            NcApiGetMsgAsHostUappStatus(raw, &message->msg.uapp_status);
+            break;
+        case HostDataEnum:
+            NcApiGetMsgAsHostData(raw, &message->msg.host_data);
+            break;
+        case HostDataHapaEnum:
+            NcApiGetMsgAsHostDataHapa(raw, &message->msg.host_data_hapa);
+            break;
+        case HostUappDataEnum:
+            NcApiGetMsgAsHostUappData(raw, &message->msg.host_uapp_data);
+            break;
+        case HostUappDataHapaEnum:
+            NcApiGetMsgAsHostUappDataHapa(raw, &message->msg.host_uapp_data_hapa);
+            break;
+        case NodeInfoReplyEnum:
+            NcApiGetMsgAsNodeInfoReply(raw, &message->msg.node_info_reply);
+            break;
+        case NeighborListReplyEnum:
+            NcApiGetMsgAsNeighborListReply(raw, &message->msg.neighbor_list_reply);
+            break;
+        case RouteInfoRequestReplyEnum:
+            NcApiGetMsgAsRouteInfoRequestReply(raw, &message->msg.route_info_reply);
+            break;
+        case NetCmdReplyEnum:
+            NcApiGetMsgAsNetCmdResponse(raw, &message->msg.net_cmd_reply);
+            break;
+        case WesStatusEnum:
+            NcApiGetMsgAsWesStatus(raw, &message->msg.wes_status);
+            break;
+        case WesSetupRequestEnum:
+            NcApiGetMsgAsWesSetupRequest(raw, &message->msg.wes_setup_request);
+            break;
+    }
+}
+
+void NeoMesh::cts_interrupt()
+{
+    // Runs in interrupt context. Only records where in the byte stream the edge happened
+    uint8_t head = this->cts_head;
+    if ((uint8_t)(head - this->cts_tail) >= NEOMESH_CTS_QUEUE_SIZE)
+    {
+        this->cts_overflow++;
+        return;
+    }
+    this->cts_positions[head % NEOMESH_CTS_QUEUE_SIZE] = this->rx_consumed + this->rx_ring_count() + this->serial->available();
+    this->cts_head = head + 1;
+}
+
+void NeoMesh::handle_cts()
+{
+    if (this->rx_lost && (int16_t)(this->rx_lost_position - this->rx_consumed) <= 0)
+    {
+        // Bytes were lost here. Ignore everything until CTS marks the start of a frame
+        this->rx_lost = false;
+        g_ncApi[this->uart_num].recvBufIsSynced = 0;
+        g_ncApi[this->uart_num].rxPosition = 0;
+    }
+
+    // Handle the edges whose bytes before them have all been passed to NcApi. Positions are
+    // read with interrupts off, as a drain from an interrupt may move them back
+    uint8_t tail = this->cts_tail;
+    while (tail != this->cts_head)
+    {
+        noInterrupts();
+        uint16_t position = this->cts_positions[tail % NEOMESH_CTS_QUEUE_SIZE];
+        interrupts();
+        if ((int16_t)(position - this->rx_consumed) > 0)
+            break;
+        tail++;
+        this->cts_tail = tail;
+        NcApiCtsActive(this->uart_num);
+    }
+}
+
+int NeoMesh::read_rx_byte()
+{
+    // The CTS interrupt reads rx_consumed plus the bytes waiting, which must not change in between
+    if (this->rx_ring == nullptr)
+    {
+        noInterrupts();
+        int c = this->serial->available() ? this->serial->read() : -1;
+        if (c >= 0)
+            this->rx_consumed++;
+        interrupts();
+        return c;
+    }
+
+    if (this->rx_ring_head == this->rx_ring_tail)
+        this->drain_serial();
+    if (this->rx_ring_head == this->rx_ring_tail)
+        return -1;
+
+    uint8_t tail = this->rx_ring_tail;
+    uint8_t c = this->rx_ring[tail];
+    noInterrupts();
+    this->rx_ring_tail = (tail + 1) % this->rx_ring_size;
+    this->rx_consumed++;
+    interrupts();
+    return c;
+}
+
+bool NeoMesh::probe_baudrate(uint32_t baudrate)
+{
+    this->serial->flush();
+    this->hw_serial->begin(baudrate);
+
+    // Throw away what was received at the old rate, and expect a frame to start with the next byte
+    while (this->serial->available())
+        this->serial->read();
+    noInterrupts();
+    this->rx_ring_tail = this->rx_ring_head;
+    this->rx_lost = false;
+    this->cts_tail = this->cts_head;
+    interrupts();
+    g_ncApi[this->uart_num].recvBufIsSynced = 1;
+    g_ncApi[this->uart_num].rxPosition = 0;
+
+    // Written directly, as the NcApi TX slot waits for CTS, which the module may not give
+    const uint8_t request[2] = { NodeInfoRequestEnum, NCAPI_NODEINFOREQUEST_LENGTH };
+    this->node_info_received = false;
+    this->serial->write(request, sizeof(request));
+
+    uint32_t waiting_since = millis();
+    while (!this->node_info_received && millis() - waiting_since < NEOMESH_PROBE_TIMEOUT_MS)
+        this->update();
+    return this->node_info_received;
+}
+
+uint32_t NeoMesh::time_to_next_event()
+{
+    if (this->work_pending())
+        return 0;
+
+    uint32_t now = millis();
+    uint32_t next = this->tx_queue.time_to_expiry(now);
+    if (this->tx_write_msg != nullptr)
+        next = 1;   // The serial driver is sending the previous part of the frame
+
+    // Frames waiting for the NcApi TX slot are sent when CTS frees it, which wakes the MCU
+    if (this->module_mode == AAPI && NcApiStatus(this->uart_num) == NCAPI_OK)
+    {
+        uint8_t limit = this->airtime_priority_limit(now);
+        uint32_t send = this->tx_queue.time_to_send(now, limit);
+        if (limit != NEOMESH_PRIORITY_COUNT && this->tx_queue.count() != 0)
+        {
+            uint32_t allowed = this->airtime.time_until_allowed(now, NEOMESH_MAX_FRAME_LENGTH);
+            if (allowed < send)
+                send = allowed;
+        }
+        if (send < next)
+            next = send;
+    }
+
+    if (this->slot_frame_pending && this->slot_frame.has_deadline)
+    {
+        int32_t left = this->slot_frame.deadline - now;
+        uint32_t ms = left > 0 ? left : 0;
+        if (ms < next)
+            next = ms;
+    }
+
+    if (this->bulk != nullptr)
+    {
+        uint32_t bulk = this->bulk->time_to_next_event();
+        if (bulk < next)
+            next = bulk;
+    }
+    return next;
+}
+
+uint8_t NeoMesh::airtime_priority_limit(uint32_t now)
+{
+    // Checked for the largest frame, so the budget holds whichever frame is sent next
+    bool limited = !this->airtime.allows(now, NEOMESH_MAX_FRAME_LENGTH);
+    if (limited && !this->airtime_limited)
+        this->airtime.held_back();
+    this->airtime_limited = limited;
+    return limited ? NEOMESH_PRIORITY_CONTROL + 1 : NEOMESH_PRIORITY_COUNT;
+}
+
+uint8_t NeoMesh::rx_ring_count()
+{
+    if (this->rx_ring == nullptr)
+        return 0;
+    return ((uint16_t)this->rx_ring_head + this->rx_ring_size - this->rx_ring_tail) % this->rx_ring_size;
+}
+
+bool NeoMesh::continue_write()
+{
+    uint8_t remaining = this->tx_write_length - this->tx_write_done;
+    int room = this->serial->availableForWrite();
+    if (room > 0)
+    {
+        this->tx_blocking = false;  // The stream reports room, so it was only full
+    }
+    else
+    {
+        // Some streams always report 0. Write those blocking, as before
+        if (!this->tx_blocking && millis() - this->tx_write_progress_at < NEOMESH_TX_STALL_MS)
+            return false;
+        this->tx_blocking = true;
+        room = remaining;
+    }
+
+    uint8_t count = room < remaining ? room : remaining;
+    this->serial->write(this->tx_write_msg + this->tx_write_done, count);
+    this->tx_write_done += count;
+    this->tx_write_progress_at = millis();
+    if (this->tx_write_done < this->tx_write_length)
+        return false;
+
+    this->tx_write_msg = nullptr;
+    return true;
+}
+
+void NeoMesh::start_dispatch(NeoMeshRxDispatch dispatch)
+{
+    this->rx_dispatch = dispatch;
+
+    NcApiInit();
+
+    g_ncApi[this->uart_num].NcApiRxHandlers = &ncRx;
+    NcApiCallbackNwuActive(this->uart_num);
+}
+
+void NeoMesh::deliver_host_data(tNcHostDataMessage *m)
+{
+    if (this->demux_host_data(m))
+        return;
+
+    switch (m->type)
+    {
+        case HostDataEnum:
+        {
+            tNcApiHostData p = {m->originId, (uint16_t)m->packageAge, m->port, m->payloadLength, m->payload};
+            if (this->host_data_callback != 0)
+                this->host_data_callback(&p);
+            break;
+        }
+        case HostDataHapaEnum:
+        {
+            tNcApiHostDataHapa p = {m->originId, m->packageAge, m->port, m->payloadLength, m->payload};
+            if (this->host_data_hapa_callback != 0)
+                this->host_data_hapa_callback(&p);
+            break;
+        }
+        case HostUappDataEnum:
+        {
+            tNcApiHostUappData p = {m->originId, (uint16_t)m->packageAge, m->port, m->appSeqNo, m->payloadLength, m->payload};
+            if (this->host_uapp_data_callback != 0)
+                this->host_uapp_data_callback(&p);
+            break;
+        }
+        case HostUappDataHapaEnum:
+        {
+            tNcApiHostUappDataHapa p = {m->originId, m->packageAge, m->port, m->appSeqNo, m->payloadLength, m->payload};
+            if (this->host_uapp_data_hapa_callback != 0)
+                this->host_uapp_data_hapa_callback(&p);
+            break;
+        }
+    }
+}
+
+bool NeoMesh::demux_host_data(tNcHostDataMessage *m)
+{
+    if (this->is_bulk_frame(m->type, m->port))
+    {
+        this->bulk->frame_received(m->originId, m->payload, m->payloadLength);
+        return true;
+    }
+
+    NeoMeshPortHandler handler = this->find_port_handler(m->type, m->port, m->originId);
+    if (handler == 0)
+        return false;
+    handler(m);
+    return true;
+}
+
+bool NeoMesh::demux_host_data(const AnyHostDataView &view)
+{
+    if (this->is_bulk_frame(view.type(), view.port()))
+    {
+        this->bulk->frame_received(view.origin(), (uint8_t *) view.payload(), view.payload_length());
+        return true;
+    }
+
+    NeoMeshPortHandler handler = this->find_port_handler(view.type(), view.port(), view.origin());
+    if (handler == 0)
+        return false;
+    tNcHostDataMessage m = {view.type(), view.origin(), view.age(), view.port(), view.seq(), view.payload_length(), (uint8_t *) view.payload()};
+    handler(&m);
+    return true;
+}
+
+bool NeoMesh::is_bulk_frame(uint8_t type, uint8_t port)
+{
+    return this->bulk != nullptr && port == this->bulk_port && (type == HostUappDataEnum || type == HostUappDataHapaEnum);
+}
+
+NeoMeshPortHandler NeoMesh::find_port_handler(uint8_t type, uint8_t port, uint16_t originId)
+{
+    if (port >= NEOMESH_PORT_COUNT)
+        return NeoMeshPortHandler();
+    uint8_t i = type - HostDataEnum;
+    uint16_t origin = this->port_handler_origins[i][port];
+    if (origin != 0 && origin != originId)
+        return NeoMeshPortHandler();
+    return this->port_handlers[i][port];
+}
+
 void NeoMesh::read_callback_(uint8_t n, uint8_t *msg, uint8_t msgLength)
 {
     if (instances[n]->read_callback != 0)
@@ -331,26 +1350,85 @@ void NeoMesh::read_callback_(uint8_t n, uint8_t *msg, uint8_t msgLength)
 
  void NeoMesh::host_ack_callback_(uint8_t n, tNcApiHostAckNack *p)
 {
+    instances[n]->tx_queue.congestion_feedback(p->originId, false);
     if (instances[n]->host_ack_callback != 0)
         instances[n]->host_ack_callback(p);
 }
 
 void NeoMesh::host_nack_callback_(uint8_t n, tNcApiHostAckNack *p)
 {
+    instances[n]->tx_queue.congestion_feedback(p->originId, true);
     if (instances[n]->host_nack_callback != 0)
         instances[n]->host_nack_callback(p);
 }
 
-void NeoMesh::host_data_callback_(uint8_t n, tNcApiHostData *m)
+void NeoMesh::host_data_frame_(uint8_t n, uint8_t *msg)
 {
-    if (instances[n]->host_data_callback != 0)
-        instances[n]->host_data_callback(m);
+    // Bulk transfers and port handlers are found through a view of the frame. The frame is
+    // only decoded into the NcApi struct of its type if the callback for it is set
+    NeoMesh *neo = instances[n];
+    AnyHostDataView view(msg);
+    if (neo->demux_host_data(view))
+        return;
+
+    switch (view.type())
+    {
+        case HostDataEnum:
+            if (neo->host_data_callback != 0)
+            {
+                tNcApiHostData m;
+                NcApiGetMsgAsHostData(msg, &m);
+                neo->host_data_callback(&m);
+            }
+            break;
+        case HostDataHapaEnum:
+            if (neo->host_data_hapa_callback != 0)
+            {
+                tNcApiHostDataHapa m;
+                NcApiGetMsgAsHostDataHapa(msg, &m);
+                neo->host_data_hapa_callback(&m);
+            }
+            break;
+        case HostUappDataEnum:
+            if (neo->host_uapp_data_callback != 0)
+            {
+                tNcApiHostUappData m;
+                NcApiGetMsgAsHostUappData(msg, &m);
+                neo->host_uapp_data_callback(&m);
+            }
+            break;
+        case HostUappDataHapaEnum:
+            if (neo->host_uapp_data_hapa_callback != 0)
+            {
+                tNcApiHostUappDataHapa m;
+                NcApiGetMsgAsHostUappDataHapa(msg, &m);
+                neo->host_uapp_data_hapa_callback(&m);
+            }
+            break;
+    }
+}
+
+void NeoMesh::dispatch_all(uint8_t n, uint8_t *msg, uint8_t msgLength)
+{
+    NeoMesh::read_callback_(n, msg, msgLength);
+    NeoMeshDispatcher<HostAckEnum, HostNAckEnum, HostDataEnum, HostDataHapaEnum, HostUappDataEnum, HostUappDataHapaEnum,
+        HostUappDataSend, HostUappDataDropped, NodeInfoReplyEnum, NetCmdReplyEnum, WesStatusEnum, WesSetupRequestEnum>::dispatch(n, msg);
 }
 
-void NeoMesh::host_data_hapa_callback_(uint8_t n, tNcApiHostDataHapa *p)
+void NeoMesh::host_uapp_send_callback_(uint8_t n, tNcApiHostUappStatus *p)
 {
-    if (instances[n]->host_data_hapa_callback != 0)
-        instances[n]->host_data_hapa_callback(p);
+    instances[n]->resolve_uapp(p, false);
+    instances[n]->tx_queue.congestion_feedback(p->originId, false);
+    if (instances[n]->host_uapp_send_callback != 0)
+        instances[n]->host_uapp_send_callback(p);
+}
+
+void NeoMesh::host_uapp_dropped_callback_(uint8_t n, tNcApiHostUappStatus *p)
+{
+    instances[n]->resolve_uapp(p, true);
+    instances[n]->tx_queue.congestion_feedback(p->originId, true);
+    if (instances[n]->host_uapp_dropped_callback != 0)
+        instances[n]->host_uapp_dropped_callback(p);
 }
 
 void NeoMesh::wes_setup_request_callback_(uint8_t n, tNcApiWesSetupRequest *p)
@@ -366,20 +1444,41 @@ void NeoMesh::wes_status_callback_(uint8_t n, tNcApiWesStatus *p)
     return ;
 }
 
+void NeoMesh::node_info_reply_callback_(uint8_t n, tNcApiNodeInfoReply *p)
+{
+    NeoMesh * neo = instances[n];
+    neo->node_info_received = true;
+    neo->node_info = *p;
+    if (!neo->ready)
+    {
+        neo->ready = true;
+        neo->time_to_ready = millis() - neo->started_at;
+    }
+
+    if (neo->node_info_reply_callback != 0)
+        neo->node_info_reply_callback(p);
+}
+
+void NeoMesh::net_cmd_response_callback_(uint8_t n, tNcApiNetCmdReply *p)
+{
+    if (instances[n]->net_cmd_response_callback != 0)
+        instances[n]->net_cmd_response_callback(p);
+}
+
 void NeoMesh::pass_through_cts()
 {
-    NcApiCtsActive(0);
+    instances[0]->cts_interrupt();
 }
 
 NcApiErrorCodes NcApiSupportTxData(uint8_t n, uint8_t *finalMsg, uint8_t finalMsgLength)
 {
-    instances[n]->write(finalMsg, finalMsgLength);
-    return NCAPI_OK;
+    // When the frame does not fit in the serial TX buffer, update() writes the rest and calls NcApiTxDataDone
+    return instances[n]->write(finalMsg, finalMsgLength) ? NCAPI_OK : NCAPI_DATA_PENDING;
 }
 
 void NcApiSupportMessageReceived(uint8_t n, void *callbackToken, uint8_t *msg, uint8_t msgLength)
 {
-    NcApiExecuteCallbacks(n, msg, msgLength);
+    instances[n]->message_received(msg, msgLength);
 }
 
 void NcApiSupportMessageWritten(uint8_t n, void *callbackToken, uint8_t *finalMsg, uint8_t finalMsgLength)
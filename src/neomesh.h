@@ -21,7 +21,19 @@
 #include <Stream.h>
 #include <Arduino.h>
 #include "NcApi.h"
+#include "NeoParser.h"
 #include "SAPIParser.h"
+#include "TxQueue.h"
+#include "RxPool.h"
+#include "RxFilter.h"
+#include "FrameView.h"
+#include "PayloadSchema.h"
+#include "Delegate.h"
+#include "AirtimeGovernor.h"
+
+class BulkTransfer;
+template <uint8_t TYPE> struct NeoMeshDecoder;
+template <uint8_t... TYPES> struct NeoMeshDispatcher;
 
 /*******************************************************************************
  *    Defines
@@ -29,6 +41,25 @@
 
 #define DEFAULT_NEOCORTEC_BAUDRATE 115200
 
+#ifndef NEOMESH_PROBE_BAUDRATES
+#define NEOMESH_PROBE_BAUDRATES {115200, 230400, 460800, 921600, 57600, 38400, 19200, 9600}   //!< Baud rates tried by detect_baudrate, in order
+#endif
+
+#ifndef NEOMESH_PROBE_TIMEOUT_MS
+#define NEOMESH_PROBE_TIMEOUT_MS 100    //!< Time to wait for the module to answer at each baud rate
+#endif
+
+#ifndef NEOMESH_READY_TIMEOUT_MS
+#define NEOMESH_READY_TIMEOUT_MS 2000   //!< Default time wait_ready waits for the module to answer
+#endif
+
+#ifndef UART_BAUDRATE_SETTING
+// The id of the AAPI UART baud rate setting is not part of NcApi and depends on the module firmware.
+// It must be taken from the module's setting list and defined to use change_baudrate. While it is 0,
+// change_baudrate does nothing, so no guessed setting is written to the module's flash
+#define UART_BAUDRATE_SETTING 0     //!< Id of the module's AAPI UART baud rate setting. 0 if unknown
+#endif
+
 #define SAPI_COMMAND_HEAD 0x3E
 #define SAPI_COMMAND_TAIL 0x21
 #define SAPI_COMMAND_LOGIN1 0x01
@@ -52,6 +83,28 @@
 
 #define DEFAULT_PASSWORD_LVL10 {0x4c, 0x76, 0x6c, 0x31, 0x30}
 
+#define NCAPI_APPSEQNO_MASK 0x0fff  // appSeqNo only has 12 valid bits
+
+#ifndef NEOMESH_MAX_DESTINATIONS
+#define NEOMESH_MAX_DESTINATIONS 8  //!< Number of destinations that get their own appSeqNo counter
+#endif
+
+#define NEOMESH_PORT_COUNT 5             // Ports 0 to 4
+#define NEOMESH_HOST_DATA_TYPES 4       // HostDataEnum to HostUappDataHapaEnum
+#define NEOMESH_ALL_HOST_DATA 0         // Register a port handler for all four host data types
+
+#ifndef NEOMESH_CTS_QUEUE_SIZE
+#define NEOMESH_CTS_QUEUE_SIZE 4    //!< CTS edges that can wait for update(). Must be a power of two
+#endif
+
+#ifndef NEOMESH_TX_STALL_MS
+#define NEOMESH_TX_STALL_MS 20      //!< Time without room in the serial TX buffer before writes fall back to blocking
+#endif
+
+#ifndef NEOMESH_UAPP_TRACKING_SIZE
+#define NEOMESH_UAPP_TRACKING_SIZE 4    //!< Number of unacknowledged frames that can be tracked at once
+#endif
+
 /*******************************************************************************
  *    Type defines
  ******************************************************************************/
@@ -61,6 +114,77 @@ typedef struct {
     uint8_t length;
 } NcSetting;
 
+/**
+* @brief An unacknowledged frame that has been handed to the NeoCortec module,
+* but for which no HostUappDataSend or HostUappDataDropped has been received yet
+*/
+typedef struct {
+    uint16_t destNodeId;
+    uint8_t port;
+    uint16_t appSeqNo;
+    uint32_t sent_at;   // millis() when the frame was handed to NcApi
+    uint8_t payloadLength;
+    uint8_t payload[NCAPI_MAX_PAYLOAD_LENGTH];
+} tNcUappFrame;
+
+/**
+* @brief Counters for unacknowledged frames
+*/
+typedef struct {
+    uint32_t sent;      // Tracked frames handed to NcApi
+    uint32_t confirmed; // HostUappDataSend received for a tracked frame
+    uint32_t dropped;   // HostUappDataDropped received for a tracked frame
+    uint32_t evicted;   // Frames that were pushed out of the tracking table before any status arrived
+    uint32_t untracked; // Status received for a frame that was not tracked, e.g. a bulk transfer frame
+} tNcUappStats;
+
+/**
+* @brief Counters for the transmit queue
+*/
+typedef struct {
+    uint32_t queued;        // Frames accepted by a send function
+    uint32_t dispatched;    // Frames handed to NcApi
+    uint32_t expired;       // Frames dropped because their time to live ran out
+} tNcTxStats;
+
+/**
+* @brief Host data of any of the four host data message types, as passed to port handlers
+*/
+typedef struct {
+    uint8_t type;           // HostDataEnum, HostDataHapaEnum, HostUappDataEnum or HostUappDataHapaEnum
+    uint16_t originId;
+    uint32_t packageAge;
+    uint8_t port;
+    uint16_t appSeqNo;      // 0 for acknowledged host data
+    uint8_t payloadLength;
+    uint8_t * payload;
+} tNcHostDataMessage;
+
+/**
+* @brief A received message returned by poll
+* @details type selects which member of msg is valid. Payload pointers in msg point
+* into raw, so they are only valid as long as this struct is not moved or overwritten
+*/
+typedef struct {
+    uint8_t type;   // NcApiMessageType
+    union {
+        tNcApiHostAckNack ack;                      // HostAckEnum, HostNAckEnum
+        tNcApiHostUappStatus uapp_status;           // HostUappDataSend, HostUappDataDropped
+        tNcApiHostData host_data;
+        tNcApiHostDataHapa host_data_hapa;
+        tNcApiHostUappData host_uapp_data;
+        tNcApiHostUappDataHapa host_uapp_data_hapa;
+        tNcApiNodeInfoReply node_info_reply;
+        tNcApiNeighborListReply neighbor_list_reply;
+        tNcApiRouteInfoRequestReply route_info_reply;
+        tNcApiNetCmdReply net_cmd_reply;
+        tNcApiWesStatus wes_status;
+        tNcApiWesSetupRequest wes_setup_request;
+    } msg;
+    uint8_t length;
+    uint8_t raw[NEOMESH_RX_BLOCK_SIZE];
+} tNcMessage;
+
 /**
 * @brief Enum to keep track of module modes
 */
@@ -88,12 +212,14 @@ typedef enum {
  *
  * \details This function will deliver a byte array containing the received raw UART frame. <br>
  * It is normally not necessary to register for this callback, as there are other callbacks 
- * which are specific to the various types of application data.
+ * which are specific to the various types of application data. <br>
+ * The frame can be read without decoding all of it through the views in FrameView.h,
+ * e.g. tNcHostUappDataView(msg).origin()
  *
  * @param msg Pointer to the message
  * @param msgLength Message length in bytes
  */
-typedef void (*NeoMeshReadCallback)(uint8_t * msg, uint8_t msgLength);
+typedef Delegate<void(uint8_t * msg, uint8_t msgLength)> NeoMeshReadCallback;
 
 /**
  * \brief Application provided functions that NcApi calls when a <br> 
@@ -106,7 +232,7 @@ typedef void (*NeoMeshReadCallback)(uint8_t * msg, uint8_t msgLength);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshHostAckCallback)(tNcApiHostAckNack * m);
+typedef Delegate<void(tNcApiHostAckNack * m)> NeoMeshHostAckCallback;
 
 
 
@@ -121,7 +247,27 @@ typedef void (*NeoMeshHostAckCallback)(tNcApiHostAckNack * m);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshHostUappStatusCallback)(tNcApiHostUappStatus * m);
+typedef Delegate<void(tNcApiHostUappStatus * m)> NeoMeshHostUappStatusCallback;
+
+/**
+ * \brief Application provided function that is called when the outcome of a tracked
+ * unacknowledged frame is known.
+ *
+ * \details The frame is no longer tracked when this is called, so it is safe to call
+ * send_unacknowledged from within the callback, e.g. to re-queue a dropped frame.
+ *
+ * @param frame The frame as it was originally sent
+ * @param dropped True if the module dropped the frame. False if it was sent
+ */
+typedef Delegate<void(tNcUappFrame * frame, bool dropped)> NeoMeshUappOutcomeCallback;
+
+/**
+ * \brief Application provided function that is called when a queued frame is dropped
+ * because its time to live ran out before it could be written to the module.
+ *
+ * @param frame The frame that was dropped. type tells which of the params is valid
+ */
+typedef Delegate<void(tNcTxFrame * frame)> NeoMeshTxExpiredCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -133,7 +279,7 @@ typedef void (*NeoMeshHostUappStatusCallback)(tNcApiHostUappStatus * m);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshHostDataCallback)(tNcApiHostData * m);
+typedef Delegate<void(tNcApiHostData * m)> NeoMeshHostDataCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -146,7 +292,7 @@ typedef void (*NeoMeshHostDataCallback)(tNcApiHostData * m);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshHostDataHapaCallback)(tNcApiHostDataHapa * m);
+typedef Delegate<void(tNcApiHostDataHapa * m)> NeoMeshHostDataHapaCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -158,7 +304,7 @@ typedef void (*NeoMeshHostDataHapaCallback)(tNcApiHostDataHapa * m);
  *
  * @param m Strongly typed message
  */
-typedef void(*NeoMeshHostUappDataCallback)(tNcApiHostUappData * m);
+typedef Delegate<void(tNcApiHostUappData * m)> NeoMeshHostUappDataCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -171,7 +317,17 @@ typedef void(*NeoMeshHostUappDataCallback)(tNcApiHostUappData * m);
  *
  * @param m Strongly typed message
  */
-typedef void(*NeoMeshHostUappDataHapaCallback)(tNcApiHostUappDataHapa * m);
+typedef Delegate<void(tNcApiHostUappDataHapa * m)> NeoMeshHostUappDataHapaCallback;
+
+/**
+ * \brief Application provided function registered with register_port_handler
+ *
+ * \details Called instead of the host data callbacks for host data received on the port
+ * the function was registered for.
+ *
+ * @param m The host data
+ */
+typedef Delegate<void(tNcHostDataMessage * m)> NeoMeshPortHandler;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -179,7 +335,7 @@ typedef void(*NeoMeshHostUappDataHapaCallback)(tNcApiHostUappDataHapa * m);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshNodeInfoReplyCallback)(tNcApiNodeInfoReply * m);
+typedef Delegate<void(tNcApiNodeInfoReply * m)> NeoMeshNodeInfoReplyCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -187,7 +343,7 @@ typedef void (*NeoMeshNodeInfoReplyCallback)(tNcApiNodeInfoReply * m);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshNeighborListReplyCallback)(tNcApiNeighborListReply * m);
+typedef Delegate<void(tNcApiNeighborListReply * m)> NeoMeshNeighborListReplyCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -195,7 +351,7 @@ typedef void (*NeoMeshNeighborListReplyCallback)(tNcApiNeighborListReply * m);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshRouteInfoRequestReplyCallback)(tNcApiRouteInfoRequestReply * m);
+typedef Delegate<void(tNcApiRouteInfoRequestReply * m)> NeoMeshRouteInfoRequestReplyCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -203,7 +359,7 @@ typedef void (*NeoMeshRouteInfoRequestReplyCallback)(tNcApiRouteInfoRequestReply
  *
  * @param m Strongly typed message
  */
-typedef void(*NeoMeshNetCmdResponseCallback)(tNcApiNetCmdReply * m);
+typedef Delegate<void(tNcApiNetCmdReply * m)> NeoMeshNetCmdResponseCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -211,7 +367,7 @@ typedef void(*NeoMeshNetCmdResponseCallback)(tNcApiNetCmdReply * m);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshWesStatusCallback)(tNcApiWesStatus * m);
+typedef Delegate<void(tNcApiWesStatus * m)> NeoMeshWesStatusCallback;
 
 /**
  * \brief Application provided function that NcApi calls when a <br> 
@@ -219,11 +375,16 @@ typedef void (*NeoMeshWesStatusCallback)(tNcApiWesStatus * m);
  *
  * @param m Strongly typed message
  */
-typedef void (*NeoMeshWesSetupRequestCallback)(tNcApiWesSetupRequest * m);
+typedef Delegate<void(tNcApiWesSetupRequest * m)> NeoMeshWesSetupRequestCallback;
 
 
 
 
+/**
+ * \brief Function that decodes a received frame and calls the callbacks for it
+ */
+typedef void (*NeoMeshRxDispatch)(uint8_t n, uint8_t * msg, uint8_t msgLength);
+
 /*******************************************************************************
  *    Class prototypes
  ******************************************************************************/
@@ -241,18 +402,60 @@ public:
     */
     NeoMesh(Stream * serial, uint8_t cts_pin);
 
+    /**
+     * @brief Construct new NeoMesh object on a hardware UART
+     * @details The UART is still opened by the sketch, or by begin_serial(). Its baud rate can be
+     * detected with detect_baudrate(), which reopens it
+     * @param serial Pointer to the HardwareSerial object attached to the AAPI UART
+    */
+    NeoMesh(HardwareSerial * serial, uint8_t cts_pin);
+
     /**
      * @brief Starts the NeoMesh API
      */
     void start();
 
+    /**
+     * @brief Starts the NeoMesh API with a dispatcher for only the given message types
+     * @details start() generates a dispatcher for every supported message type. This instead
+     * generates one that only handles the listed types, and drops all other frames before the read callback.
+     * If start() is never called, the unused decoders and callbacks are left out of the
+     * program by the linker. Only code is saved: the callback members, such as host_data_callback,
+     * are still part of every NeoMesh object. E.g. neo.start_for<HostDataEnum, HostAckEnum, HostNAckEnum>()
+     * Supported types are 0x50 to 0x58, NetCmdReplyEnum, WesStatusEnum and WesSetupRequestEnum.
+     * Other types do not compile. The types the library needs itself are always included:
+     * NodeInfoReplyEnum for wait_ready and detect_baudrate, HostUappDataSend and HostUappDataDropped
+     * for tracking unacknowledged frames, and the unacknowledged host data types for bulk transfers
+     */
+    template <uint8_t... TYPES>
+    void start_for()
+    {
+        this->start_dispatch(NeoMesh::dispatch_for<TYPES..., NodeInfoReplyEnum, HostUappDataSend, HostUappDataDropped,
+            HostUappDataEnum, HostUappDataHapaEnum>);
+    }
+
+    // IGNORE:
+    bool write(uint8_t *finalMsg, uint8_t finalMsgLength);
+
     // IGNORE:
-    void write(uint8_t *finalMsg, uint8_t finalMsgLength);
+    void message_received(uint8_t *msg, uint8_t msgLength);
 
     /**
      * @brief Handles all housekeeping. Should be called from main loop
+     * @details The MCU may sleep until the returned time has passed, or until it is woken by the
+     * CTS interrupt or by a received byte. Use a sleep mode that keeps the UART and the external
+     * interrupts running, e.g. idle on AVR, and check work_pending() with interrupts disabled before sleeping
+     * @return Time in ms until update() must be called again, at the latest. 0 if there is work now.
+     * NEOMESH_NO_DEADLINE if nothing is waiting for a timeout
      */
-    void update();
+    uint32_t update();
+
+    /**
+     * @brief See if CTS edges or received bytes are waiting for update()
+     * @details Safe to call with interrupts disabled, so a CTS edge or byte that arrives just
+     * before the MCU is put to sleep is not missed
+     */
+    bool work_pending();
 
     /**
      * @brief Change the id of the node in the NeoMesh network
@@ -290,15 +493,75 @@ public:
      */
     void set_baudrate(uint32_t baudrate);
 
+    /**
+     * @brief Open the UART at the baud rate given to set_baudrate
+     * @details Only for sketches that leave opening the UART to the library. Sketches that call
+     * begin() themselves, e.g. to set pins or frame format, must not call it, as it reopens the UART.
+     * Only possible if the object was constructed with a HardwareSerial
+     * @return False if the object was constructed with a Stream
+     */
+    bool begin_serial();
+
+    /**
+     * @brief Get the baud rate used on the UART
+     */
+    uint32_t get_baudrate();
+
+    /**
+     * @brief Find the baud rate the module is configured for
+     * @details Sends a NodeInfoRequest at the baud rate given to set_baudrate, and then at each of
+     * NEOMESH_PROBE_BAUDRATES, until the module answers. Call right after start(), before
+     * anything is sent. Only possible if the object was constructed with a HardwareSerial
+     * @return The baud rate the UART is now open at. 0 if the module did not answer at any of them
+     */
+    uint32_t detect_baudrate();
+
+    /**
+     * @brief Change the baud rate of the module and reopen the UART at it
+     * @warning Not supported out of the box. The id of the module's baud rate setting is not known
+     * to the library, so this always returns false unless UART_BAUDRATE_SETTING is defined
+     * @details The setting UART_BAUDRATE_SETTING is changed through the system interface, and
+     * the module is asked for its node info at the new rate. If it does not answer,
+     * the UART is reopened at the old rate. If the setting can not be changed, the baud rate is
+     * left as it is. Only possible if the object was constructed with a HardwareSerial and
+     * UART_BAUDRATE_SETTING is defined
+     * @param baudrate The new baud rate
+     * @param setting_value Value of UART_BAUDRATE_SETTING that selects this baud rate on the module
+     * @return True if the module answers at the new baud rate. False if the setting could not be changed,
+     * or the module did not answer at the new rate
+     */
+    bool change_baudrate(uint32_t baudrate, uint8_t setting_value);
+
     /**
      * @brief send an unacknowledged message to a node in the network
      * @param destNodeId The node id of the recepient
      * @param port Which port to send to. Allows recepient to filter messages. If not used, write 0
      * @param appSeqNo message sequence number. If more messages are sent after each other, the sequence number must be different each time
      * @param payload The payload data to send
-     * @param payloadLen The length of the payload array
+     * @param payloadLen The length of the payload array. At most NEOMESH_MAX_UNACK_PAYLOAD_LENGTH
+     * @param priority Priority in the transmit queue. See tNcPriority
+     * @param ttl_ms Drop the message if it has not been written to the module within this many ms. 0 to never drop
+     * @return NCAPI_OK if the message was queued. Anything else is an error
      */
-    void send_unacknowledged(uint16_t destNodeId, uint8_t port, uint16_t appSeqNo, uint8_t *payload, uint8_t payloadLen);
+    NcApiErrorCodes send_unacknowledged(uint16_t destNodeId, uint8_t port, uint16_t appSeqNo, uint8_t *payload, uint8_t payloadLen, uint8_t priority = NEOMESH_PRIORITY_NORMAL, uint32_t ttl_ms = 0);
+
+    /**
+     * @brief send an unacknowledged message with an automatically assigned sequence number
+     * Every destination has its own 12 bit sequence number counter, which is only advanced
+     * when the message is accepted. When more than NEOMESH_MAX_DESTINATIONS destinations are used,
+     * the least recently used counter is replaced, and its destination later continues from
+     * a counter shared by all destinations. The message is tracked until the module reports that it
+     * was sent or dropped, see uapp_outcome_callback
+     * @param destNodeId The node id of the recepient
+     * @param port Which port to send to. Allows recepient to filter messages. If not used, write 0
+     * @param payload The payload data to send
+     * @param payloadLen The length of the payload array. At most NEOMESH_MAX_UNACK_PAYLOAD_LENGTH
+     * @param appSeqNo Optional pointer in which to put the assigned sequence number
+     * @param priority Priority in the transmit queue. See tNcPriority
+     * @param ttl_ms Drop the message if it has not been written to the module within this many ms. 0 to never drop
+     * @return NCAPI_OK if the message was queued. Anything else is an error
+     */
+    NcApiErrorCodes send_unacknowledged(uint16_t destNodeId, uint8_t port, uint8_t *payload, uint8_t payloadLen, uint16_t *appSeqNo = nullptr, uint8_t priority = NEOMESH_PRIORITY_NORMAL, uint32_t ttl_ms = 0);
 
     /**
      * @brief send an acknowledged message to a node in the network
@@ -307,21 +570,161 @@ public:
      * @param port Which port to send to. Allows recepient to filter messages. If not used, write 0
      * @param payload The payload data to send
      * @param payloadLen The length of the payload array
+     * @param priority Priority in the transmit queue. See tNcPriority
+     * @param ttl_ms Drop the message if it has not been written to the module within this many ms. 0 to never drop
+     * @return NCAPI_OK if the message was queued. Anything else is an error
      */
-    void send_acknowledged(uint16_t destNodeId, uint8_t port, uint8_t *payload, uint8_t payloadLen);
+    NcApiErrorCodes send_acknowledged(uint16_t destNodeId, uint8_t port, uint8_t *payload, uint8_t payloadLen, uint8_t priority = NEOMESH_PRIORITY_NORMAL, uint32_t ttl_ms = 0);
 
     /**
      * @brief Send a WES command to the node
+     * Sent with NEOMESH_PRIORITY_CONTROL
      * @param cmd The command
+     * @return NCAPI_OK if the command was queued. Anything else is an error
      */
-    void send_wes_command(NcApiWesCmdValues cmd);
+    NcApiErrorCodes send_wes_command(NcApiWesCmdValues cmd);
 
     /**
      * @brief Send a wes response
+     * Sent with NEOMESH_PRIORITY_CONTROL
      * @param uid
      * @param nodeId
+     * @return NCAPI_OK if the response was queued. Anything else is an error
+     */
+    NcApiErrorCodes send_wes_respond(uint64_t uid, uint16_t nodeId);
+
+    /**
+     * @brief Send a network command to a node in the network
+     * Sent with NEOMESH_PRIORITY_CONTROL. The reply is delivered to net_cmd_response_callback
+     * @param destNodeId The node id of the recepient
+     * @param cmd The command
+     * @param payload Command payload, if any
+     * @param payloadLen The length of the payload array
+     * @return NCAPI_OK if the command was queued. Anything else is an error
+     */
+    NcApiErrorCodes send_net_cmd(uint16_t destNodeId, NcApiNetCmdValues cmd, uint8_t *payload = nullptr, uint8_t payloadLen = 0);
+
+    /**
+     * @brief Ask the attached module for its node id, UID and hardware type
+     * Sent with NEOMESH_PRIORITY_CONTROL. The reply is delivered to node_info_reply_callback
+     * @return NCAPI_OK if the request was queued. Anything else is an error
+     */
+    NcApiErrorCodes send_node_info_request();
+
+    /**
+     * @brief Wait until the module is ready to send
+     * @details Sends a NodeInfoRequest and waits for the reply. The module only lets the request
+     * through when it is ready, so the reply is the earliest point where frames can be sent.
+     * Returns right away if a NodeInfoReply has already been received since start()
+     * @param timeout_ms Maximum time to wait
+     * @return True if the module is ready. False if it did not answer in time
+     */
+    bool wait_ready(uint32_t timeout_ms = NEOMESH_READY_TIMEOUT_MS);
+
+    /**
+     * @brief See if a NodeInfoReply has been received since start()
+     * @details Can be polled instead of calling wait_ready, after calling send_node_info_request
+     */
+    bool is_ready();
+
+    /**
+     * @brief Get time from start() until the first NodeInfoReply. In milliseconds
+     * @return The time, or 0 if the module is not ready yet
+     */
+    uint32_t get_time_to_ready();
+
+    /**
+     * @brief Get node id of the attached module, from the last NodeInfoReply
+     * @return The node id, or 0 if the module is not ready yet
+     */
+    uint16_t get_node_id();
+
+    /**
+     * @brief Get node id, UID and hardware type of the attached module, from the last NodeInfoReply
+     */
+    tNcApiNodeInfoReply get_node_info();
+
+    /**
+     * @brief Get number of frames waiting in the transmit queue
+     * @details Frames are queued by all send functions and handed to the module
+     * in priority order from update()
+     */
+    uint8_t get_tx_queue_count();
+
+    /**
+     * @brief Get counters for the transmit queue
+     */
+    tNcTxStats get_tx_stats();
+
+    /**
+     * @brief Limit the estimated airtime used per sliding window
+     * @details Airtime is estimated from the frames written to the module, see AirtimeGovernor.
+     * When the next frame could use the last NEOMESH_AIRTIME_RESERVE percent of the budget,
+     * frames other than NEOMESH_PRIORITY_CONTROL wait in the transmit queue until enough of the
+     * window has passed. Frames sent with a time to live are dropped if it runs out while waiting
+     * @param budget_ms Airtime allowed per window. 0 for no limit
+     * @param window_ms Length of the window
+     */
+    void set_airtime_budget(uint32_t budget_ms, uint32_t window_ms = NEOMESH_AIRTIME_WINDOW_MS);
+
+    /**
+     * @brief Set how airtime is estimated from the frames written to the module
+     * @param frame_us Airtime of a frame apart from its bytes
+     * @param byte_us Airtime of each byte
+     */
+    void set_airtime_model(uint16_t frame_us, uint16_t byte_us);
+
+    /**
+     * @brief Get estimated airtime used in the current window. In milliseconds
+     */
+    uint32_t get_airtime_used();
+
+    /**
+     * @brief Get counters for the airtime governor
+     */
+    tNcAirtimeStats get_airtime_stats();
+
+    /**
+     * @brief Limit how often data frames are sent to a destination
+     * @details Data frames are sent to the destinations with queued frames in turn (deficit round robin),
+     * so one busy destination does not hold back the others. A rate limit additionally caps how
+     * often a single destination is served. Control frames are never rate limited
+     * @param destNodeId The destination
+     * @param frames_per_minute Sustained rate
+     * @param burst Number of frames that may be sent back to back after an idle period
+     * @return True if the limit was set. False if NEOMESH_MAX_FLOWS destinations are already in use
+     */
+    bool set_rate_limit(uint16_t destNodeId, uint16_t frames_per_minute, uint8_t burst = 1);
+
+    /**
+     * @brief Remove a rate limit set by set_rate_limit
+     * @param destNodeId The destination
+     */
+    bool clear_rate_limit(uint16_t destNodeId);
+
+    /**
+     * @brief Get the rate limit currently applied to a destination
+     * @param destNodeId The destination
+     * @return Frames per minute. 0 if the destination is not rate limited
+     */
+    uint16_t get_rate_limit(uint16_t destNodeId);
+
+    /**
+     * @brief Adapt the send rate of each destination to how congested the mesh is
+     * @details Every destination without a rate limit from set_rate_limit gets one that is raised
+     * a little for every HostAck or HostUappDataSend, and halved for every HostNAck or
+     * HostUappDataDropped (AIMD). This keeps a gateway from flooding the network when many nodes
+     * are busy, while still using the capacity that is available
+     * @param initial_fpm Frames per minute a destination starts out with
+     * @param min_fpm Lowest rate a destination is slowed down to
+     * @param max_fpm Highest rate a destination is allowed to reach
+     */
+    void enable_congestion_control(uint16_t initial_fpm = 30, uint16_t min_fpm = 2, uint16_t max_fpm = 600);
+
+    /**
+     * @brief Stop adapting send rates and remove the rate limits set by congestion control
      */
-    void send_wes_respond(uint64_t uid, uint16_t nodeId);
+    void disable_congestion_control();
     
     /**
     * @brief Change the password the API should use to log into the NC module
@@ -440,34 +843,475 @@ public:
     */
     tNcModuleMode get_module_mode();
 
+    /**
+    * @brief Get counters for unacknowledged frames
+    * @details Drop rate can be calculated as dropped / (confirmed + dropped)
+    */
+    tNcUappStats get_uapp_stats();
+
+    /**
+    * @brief Get number of unacknowledged frames waiting for a send or drop status
+    */
+    uint8_t get_outstanding_uapp_count();
+
+    /**
+    * @brief Let a BulkTransfer object handle all unacknowledged frames on its port
+    * @details Called by the BulkTransfer constructor. Frames on the port are not passed
+    * to host_uapp_data_callback or host_uapp_data_hapa_callback. Frames sent to the port are
+    * not tracked, so a transfer does not push other frames out of the tracking table
+    * @param bulk The bulk transfer endpoint
+    * @return False if another BulkTransfer is already attached
+    */
+    bool attach_bulk_transfer(BulkTransfer * bulk);
+
+    /**
+    * @brief Keep the frame that is being delivered to the current callback
+    * @details Normally the payload pointers of a received message are only valid until the
+    * callback returns. After this is called from within a callback, the message and its payload
+    * stay valid until the frame is given back with release_rx_frame, so it can be handed on
+    * to e.g. a queue without copying it. Only NEOMESH_RX_POOL_SIZE frames can be kept at once
+    * @return The frame, or nullptr if called outside a callback or no frame could be kept
+    */
+    tNcRxFrame * take_rx_frame();
+
+    /**
+    * @brief Give back a frame kept with take_rx_frame
+    * @param frame The frame
+    */
+    void release_rx_frame(tNcRxFrame * frame);
+
+    /**
+    * @brief Get number of frames that can still be kept with take_rx_frame
+    */
+    uint8_t get_free_rx_frames();
+
+    /**
+    * @brief Queue received messages so they can be fetched with poll instead of through callbacks
+    * @details Callbacks that are set are still called. Queued messages use blocks from the same pool
+    * as take_rx_frame, so at most NEOMESH_RX_POOL_SIZE messages can wait. Messages that arrive
+    * while the pool is empty, or are larger than NEOMESH_RX_BLOCK_SIZE, are counted as overflow
+    */
+    void enable_polling();
+
+    /**
+    * @brief Stop queueing received messages and discard those waiting
+    */
+    void disable_polling();
+
+    /**
+    * @brief Fetch the oldest received message
+    * @details update() must still be called to read from the module
+    * @param message Pointer to a message object in which to put the message
+    * @return True if a message was fetched. False if none are waiting
+    */
+    bool poll(tNcMessage * message);
+
+    /**
+    * @brief Fetch the oldest received frame without decoding it
+    * @details Read it through the views in FrameView.h, so only the fields that are used are
+    * decoded, e.g. tNcHostUappDataView(frame->data).port(). Give it back with release_rx_frame
+    * @return The frame, or nullptr if none are waiting
+    */
+    tNcRxFrame * poll_frame();
+
+    /**
+    * @brief Fetch up to count received messages, oldest first
+    * @param messages Array in which to put the messages
+    * @param count Size of the array
+    * @return Number of messages fetched
+    */
+    uint8_t poll_batch(tNcMessage * messages, uint8_t count);
+
+    /**
+    * @brief Get number of received messages that could not be queued for poll
+    */
+    uint32_t get_poll_overflow_count();
+
+    /**
+    * @brief Send host data received on a port to its own handler
+    * @details Handlers are kept in a table indexed by type and port, so finding the handler for
+    * a frame takes the same time however many are registered. Host data with a registered
+    * handler is not passed to host_data_callback and the other host data callbacks
+    * @param type HostDataEnum, HostDataHapaEnum, HostUappDataEnum, HostUappDataHapaEnum,
+    * or NEOMESH_ALL_HOST_DATA for all four
+    * @param port The port, 0 to 4
+    * @param handler The handler. Replaces any handler registered for the same type and port
+    * @param originId Only call the handler for host data from this node. 0 for any node.
+    * Host data from other nodes goes to the host data callbacks as usual
+    * @return False if type or port is not valid
+    */
+    bool register_port_handler(uint8_t type, uint8_t port, NeoMeshPortHandler handler, uint16_t originId = 0);
+
+    /**
+    * @brief Register a port handler that gets the payload decoded by a PayloadSchema
+    * @details Host data whose length does not match the schema is dropped
+    * @tparam SCHEMA The PayloadSchema of the payload
+    * @tparam HANDLER Function called with the host data and the decoded payload
+    * @param type As for register_port_handler
+    * @param port The port, 0 to 4
+    * @param originId As for register_port_handler
+    * @return False if type or port is not valid
+    */
+    template <typename SCHEMA, void (*HANDLER)(tNcHostDataMessage *m, typename SCHEMA::Type *value)>
+    bool register_schema_handler(uint8_t type, uint8_t port, uint16_t originId = 0)
+    {
+        return this->register_port_handler(type, port, NeoMesh::schema_handler<SCHEMA, HANDLER>, originId);
+    }
+
+    /**
+    * @brief Send a value encoded with a PayloadSchema as an acknowledged message
+    * @details See send_acknowledged
+    */
+    template <typename SCHEMA>
+    NcApiErrorCodes send_acknowledged_as(uint16_t destNodeId, uint8_t port, const typename SCHEMA::Type &value, uint8_t priority = NEOMESH_PRIORITY_NORMAL, uint32_t ttl_ms = 0)
+    {
+        uint8_t payload[SCHEMA::size];
+        SCHEMA::encode(value, payload);
+        return this->send_acknowledged(destNodeId, port, payload, SCHEMA::size, priority, ttl_ms);
+    }
+
+    /**
+    * @brief Send a value encoded with a PayloadSchema as an unacknowledged message
+    * @details See send_unacknowledged
+    */
+    template <typename SCHEMA>
+    NcApiErrorCodes send_unacknowledged_as(uint16_t destNodeId, uint8_t port, const typename SCHEMA::Type &value, uint16_t *appSeqNo = nullptr, uint8_t priority = NEOMESH_PRIORITY_NORMAL, uint32_t ttl_ms = 0)
+    {
+        uint8_t payload[SCHEMA::size];
+        SCHEMA::encode(value, payload);
+        return this->send_unacknowledged(destNodeId, port, payload, SCHEMA::size, appSeqNo, priority, ttl_ms);
+    }
+
+    /**
+    * @brief Pass host data on as if it had just been received
+    * @details Goes to the port handler registered for its type and port, or else to the
+    * host data callback for its type. Used to deliver messages unpacked from a larger frame
+    * @param m The host data
+    */
+    void deliver_host_data(tNcHostDataMessage *m);
+
+    /**
+    * @brief Remove handlers registered with register_port_handler
+    * @param type As for register_port_handler
+    * @param port The port, 0 to 4
+    */
+    void unregister_port_handler(uint8_t type, uint8_t port);
+
+    /**
+    * @brief Enable or disable handling of a received message type
+    * @details A disabled type is dropped from its header bytes, before it is decoded or any
+    * callback is called. This includes the library's own handling, so e.g. disabling
+    * HostUappDataSend stops tracking of unacknowledged frames
+    * @param type NcApiMessageType from HostAckEnum and up
+    * @param enabled False to drop all messages of the type
+    */
+    void set_rx_type_filter(uint8_t type, bool enabled);
+
+    /**
+    * @brief Set which ports received host data is handled on
+    * @details Host data on other ports is dropped before it is decoded. Remember the
+    * bulk transfer port if a BulkTransfer is used
+    * @param port_mask Bit n set to accept port n. NEOMESH_ALL_PORTS to accept all
+    */
+    void set_rx_port_filter(uint8_t port_mask);
+
+    /**
+    * @brief Set whether the node ids added with add_rx_origin_filter are allowed or denied
+    * @param mode NEOMESH_ORIGIN_ANY to not check origin
+    */
+    void set_rx_origin_filter_mode(tNcOriginFilterMode mode);
+
+    /**
+    * @brief Add a node id to the origin filter
+    * @return False if NEOMESH_ORIGIN_FILTER_SIZE node ids are already added
+    */
+    bool add_rx_origin_filter(uint16_t originId);
+
+    /**
+    * @brief Remove a node id from the origin filter
+    */
+    void remove_rx_origin_filter(uint16_t originId);
+
+    /**
+    * @brief Get number of received messages dropped by the filters
+    */
+    uint32_t get_rx_filtered_count();
+
     NeoMeshReadCallback read_callback = 0;
     NeoMeshHostAckCallback host_ack_callback = 0;
     NeoMeshHostAckCallback host_nack_callback = 0;
     NeoMeshHostDataCallback host_data_callback = 0;
     NeoMeshHostDataHapaCallback host_data_hapa_callback = 0;
+    NeoMeshHostUappDataCallback host_uapp_data_callback = 0;
+    NeoMeshHostUappDataHapaCallback host_uapp_data_hapa_callback = 0;
+    NeoMeshHostUappStatusCallback host_uapp_send_callback = 0;
+    NeoMeshHostUappStatusCallback host_uapp_dropped_callback = 0;
+    NeoMeshUappOutcomeCallback uapp_outcome_callback = 0;
+    NeoMeshTxExpiredCallback tx_expired_callback = 0;
     NeoMeshWesSetupRequestCallback wes_setup_request_callback = 0;
     NeoMeshWesStatusCallback wes_status_callback = 0;
+    NeoMeshNodeInfoReplyCallback node_info_reply_callback = 0;
+    NeoMeshNetCmdResponseCallback net_cmd_response_callback = 0;
 
     // IGNORE:
     static void pass_through_cts();
 
+    /**
+    * @brief Receive through a larger buffer than the serial driver's
+    * @details At 115200 baud the 64 byte buffer of HardwareSerial fills in about 5 ms. When set,
+    * drain_serial moves received bytes into this buffer, and update() reads from it.
+    * Bytes that do not fit are counted, and the parser ignores data from the gap until
+    * the next CTS, so the frame after the loss is received correctly
+    * @param buffer The buffer. nullptr to read directly from serial again
+    * @param size Size of the buffer. At most 256 bytes are used
+    */
+    void set_rx_buffer(uint8_t * buffer, uint16_t size);
+
+    /**
+    * @brief Move received bytes from serial into the buffer given to set_rx_buffer
+    * @details Called by update(). Also call it from serialEvent(), from a timer interrupt,
+    * or from inside long running code in loop(), so bytes are not lost while update() is not called
+    */
+    void drain_serial();
+
+    /**
+    * @brief Get number of received bytes lost because the buffer given to set_rx_buffer was full
+    */
+    uint32_t get_rx_overflow_count();
+
+    /**
+    * @brief Get number of CTS edges that were lost because update() was not called often enough
+    */
+    uint16_t get_cts_overflow_count();
+
 private:
+    template <uint8_t TYPE> friend struct NeoMeshDecoder;
+
     uint8_t uart_num;
     uint8_t cts_pin;
     uint32_t baudrate = DEFAULT_NEOCORTEC_BAUDRATE;
     Stream * serial;
+    HardwareSerial * hw_serial = nullptr;  // Set if the UART can be opened and its baud rate changed
     SAPIParser sapi_parser;
     tNcModuleMode module_mode = AAPI;
+    NeoMeshRxDispatch rx_dispatch = 0;
+
+    // CTS edges are queued by the interrupt and handled by update(). Each entry is the position
+    // in the received byte stream at the edge, so the receiver is resynced at the right byte.
+    // Bytes dropped by drain_serial are not part of the stream, and queued entries are moved back for them
+    volatile uint16_t cts_positions[NEOMESH_CTS_QUEUE_SIZE];
+    volatile uint8_t cts_head = 0;      // Only written by the interrupt
+    volatile uint8_t cts_tail = 0;      // Only written by update()
+    volatile uint16_t rx_consumed = 0;  // Bytes read from serial, modulo 65536. Wider than ring plus serial buffer
+    volatile uint16_t cts_overflow = 0;
+
+    // Optional receive ring filled by drain_serial and emptied by update()
+    uint8_t * rx_ring = nullptr;
+    uint16_t rx_ring_size = 0;
+    volatile uint8_t rx_ring_head = 0;      // Only written by drain_serial
+    volatile uint8_t rx_ring_tail = 0;      // Only written by update()
+    volatile bool rx_draining = false;
+    volatile bool rx_lost = false;          // True if bytes were dropped at rx_lost_position
+    volatile uint16_t rx_lost_position = 0; // Position in the byte stream of the first byte after the gap
+    volatile uint32_t rx_overflow = 0;
+
+    // Frame being written to serial a little at a time. Points into the NcApi TX buffer,
+    // which is kept until NcApiTxDataDone is called
+    uint8_t * tx_write_msg = nullptr;
+    uint8_t tx_write_length = 0;
+    uint8_t tx_write_done = 0;
+    uint32_t tx_write_progress_at = 0;  // millis() when bytes were last written
+    bool tx_blocking = false;           // True while serial does not report room with availableForWrite
+    bool node_info_received = false;    // Set when a NodeInfoReply arrives. Used to probe the module
+    bool ready = false;                 // True once a NodeInfoReply has been received since start()
+    uint32_t started_at = 0;            // millis() when start() was called
+    uint32_t time_to_ready = 0;
+    tNcApiNodeInfoReply node_info = {};
 
     uint8_t password[5] = DEFAULT_PASSWORD_LVL10; // TODO: Create setter function
 
+    TxQueue tx_queue;
+    tNcTxStats tx_stats = {};
+    AirtimeGovernor airtime;
+    bool airtime_limited = false;   // True while non-critical frames are held back
+    tNcTxFrame slot_frame;                      // Copy of the frame currently in the NcApi TX slot
+    bool slot_frame_pending = false;            // True until NcApi starts writing slot_frame
+
+    uint16_t seq_node_ids[NEOMESH_MAX_DESTINATIONS] = {0};
+    uint16_t seq_next[NEOMESH_MAX_DESTINATIONS] = {0};
+    uint16_t seq_shared_next = 0;       // Advanced by every assigned appSeqNo
+
+    tNcUappFrame uapp_frames[NEOMESH_UAPP_TRACKING_SIZE];
+    bool uapp_frame_used[NEOMESH_UAPP_TRACKING_SIZE] = {false};
+    uint32_t uapp_frame_ticket[NEOMESH_UAPP_TRACKING_SIZE];
+    tNcUappStats uapp_stats = {};
+
+    RxFilter rx_filter;
+    RxPool rx_pool;
+    tNcRxFrame * rx_current = nullptr;  // Pool block of the frame being delivered to callbacks
+    bool rx_taken = false;              // True if the application kept rx_current
+
+    bool polling = false;
+    tNcRxFrame * poll_queue[NEOMESH_RX_POOL_SIZE];
+    uint8_t poll_head = 0;
+    uint8_t poll_count = 0;
+    uint32_t poll_overflow = 0;
+
+    NeoMeshPortHandler port_handlers[NEOMESH_HOST_DATA_TYPES][NEOMESH_PORT_COUNT] = {};
+    uint16_t port_handler_origins[NEOMESH_HOST_DATA_TYPES][NEOMESH_PORT_COUNT] = {};
+
+    BulkTransfer * bulk = nullptr;
+    uint8_t bulk_port = 0;
+
+    NcApiErrorCodes check_payload_args(uint8_t type, uint16_t destNodeId, uint8_t port, uint8_t *payload, uint8_t payloadLen);
+    NcApiErrorCodes enqueue(tNcTxFrame *frame, uint32_t ttl_ms = 0);
+    void pump_tx_queue();
+    void expire_frames();
+    void frame_expired(tNcTxFrame *frame);
+    NcApiErrorCodes dispatch(tNcTxFrame *frame);
+    uint16_t *get_app_seq_no(uint16_t destNodeId);
+    bool node_info_request_pending();
+    void track_uapp(tNcApiSendUnackMessage *msg);
+    void resolve_uapp(tNcApiHostUappStatus *m, bool dropped);
+    static void decode_message(tNcMessage *message);
+    void start_dispatch(NeoMeshRxDispatch dispatch);
+    void cts_interrupt();
+    void handle_cts();
+    bool continue_write();
+    bool probe_baudrate(uint32_t baudrate);
+    uint32_t time_to_next_event();
+    uint8_t airtime_priority_limit(uint32_t now);
+    int read_rx_byte();
+    uint8_t rx_ring_count();
+    bool demux_host_data(tNcHostDataMessage *m);
+    bool demux_host_data(const AnyHostDataView &view);
+    bool is_bulk_frame(uint8_t type, uint8_t port);
+    NeoMeshPortHandler find_port_handler(uint8_t type, uint8_t port, uint16_t originId);
+
     static void read_callback_(uint8_t n, uint8_t *msg, uint8_t msgLength);
     static void host_ack_callback_(uint8_t n, tNcApiHostAckNack *p);
     static void host_nack_callback_(uint8_t n, tNcApiHostAckNack *p);
-    static void host_data_callback_(uint8_t n, tNcApiHostData *m);
-    static void host_data_hapa_callback_(uint8_t n, tNcApiHostDataHapa *p);
+    static void host_data_frame_(uint8_t n, uint8_t *msg);
+    static void host_uapp_send_callback_(uint8_t n, tNcApiHostUappStatus *p);
+    static void host_uapp_dropped_callback_(uint8_t n, tNcApiHostUappStatus *p);
     static void wes_setup_request_callback_(uint8_t n, tNcApiWesSetupRequest *p);
     static void wes_status_callback_(uint8_t n, tNcApiWesStatus *p);
+    static void node_info_reply_callback_(uint8_t n, tNcApiNodeInfoReply *p);
+    static void net_cmd_response_callback_(uint8_t n, tNcApiNetCmdReply *p);
+
+    template <typename SCHEMA, void (*HANDLER)(tNcHostDataMessage *m, typename SCHEMA::Type *value)>
+    static void schema_handler(tNcHostDataMessage *m)
+    {
+        typename SCHEMA::Type value;
+        if (SCHEMA::decode(m->payload, m->payloadLength, value))
+            HANDLER(m, &value);
+    }
+
+    static void dispatch_all(uint8_t n, uint8_t *msg, uint8_t msgLength);
+
+    template <uint8_t... TYPES>
+    static void dispatch_for(uint8_t n, uint8_t *msg, uint8_t msgLength)
+    {
+        // Only frames of a listed type are passed on, also to the read callback
+        if (!NeoMeshDispatcher<TYPES...>::listed(msg[0]))
+            return;
+        NeoMesh::read_callback_(n, msg, msgLength);
+        NeoMeshDispatcher<TYPES...>::dispatch(n, msg);
+    }
+};
+
+/**
+ * @brief Decodes one message type and calls its NeoMesh trampoline. Used by NeoMesh::start and start_for
+ * @details Only the specializations below exist, so an unsupported type fails to compile.
+ * Host data is passed on as the raw frame, and only decoded once it is known who gets it
+ */
+template <uint8_t TYPE> struct NeoMeshDecoder;
+
+/**
+ * @brief Passes a frame to the NeoMeshDecoder of its type, if the type is one of TYPES
+ */
+template <uint8_t... TYPES> struct NeoMeshDispatcher;
+
+template <> struct NeoMeshDispatcher<>
+{
+    static bool listed(uint8_t) { return false; }
+    static void dispatch(uint8_t, uint8_t *) {}
+};
+
+template <uint8_t TYPE, uint8_t... REST> struct NeoMeshDispatcher<TYPE, REST...>
+{
+    static bool listed(uint8_t type)
+    {
+        return type == TYPE || NeoMeshDispatcher<REST...>::listed(type);
+    }
+
+    static void dispatch(uint8_t n, uint8_t *msg)
+    {
+        if (msg[0] == TYPE)
+            NeoMeshDecoder<TYPE>::dispatch(n, msg);
+        else
+            NeoMeshDispatcher<REST...>::dispatch(n, msg);
+    }
+};
+
+template <> struct NeoMeshDecoder<HostAckEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { tNcApiHostAckNack m; NcApiGetMsgAsHostAck(msg, &m); NeoMesh::host_ack_callback_(n, &m); }
+};
+
+template <> struct NeoMeshDecoder<HostNAckEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { tNcApiHostAckNack m; NcApiGetMsgAsHostAck(msg, &m); NeoMesh::host_nack_callback_(n, &m); }
+};
+
+template <> struct NeoMeshDecoder<HostDataEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { NeoMesh::host_data_frame_(n, msg); }
+};
+
+template <> struct NeoMeshDecoder<HostDataHapaEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { NeoMesh::host_data_frame_(n, msg); }
+};
+
+template <> struct NeoMeshDecoder<HostUappDataEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { NeoMesh::host_data_frame_(n, msg); }
+};
+
+template <> struct NeoMeshDecoder<HostUappDataHapaEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { NeoMesh::host_data_frame_(n, msg); }
+};
+
+template <> struct NeoMeshDecoder<HostUappDataSend>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { tNcApiHostUappStatus m; NcApiGetMsgAsHostUappStatus(msg, &m); NeoMesh::host_uapp_send_callback_(n, &m); }
+};
+
+template <> struct NeoMeshDecoder<HostUappDataDropped>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { tNcApiHostUappStatus m; NcApiGetMsgAsHostUappStatus(msg, &m); NeoMesh::host_uapp_dropped_callback_(n, &m); }
+};
+
+template <> struct NeoMeshDecoder<NodeInfoReplyEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { tNcApiNodeInfoReply m; NcApiGetMsgAsNodeInfoReply(msg, &m); NeoMesh::node_info_reply_callback_(n, &m); }
+};
+
+template <> struct NeoMeshDecoder<NetCmdReplyEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { tNcApiNetCmdReply m; NcApiGetMsgAsNetCmdResponse(msg, &m); NeoMesh::net_cmd_response_callback_(n, &m); }
+};
+
+template <> struct NeoMeshDecoder<WesStatusEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { tNcApiWesStatus m; NcApiGetMsgAsWesStatus(msg, &m); NeoMesh::wes_status_callback_(n, &m); }
+};
+
+template <> struct NeoMeshDecoder<WesSetupRequestEnum>
+{
+    static void dispatch(uint8_t n, uint8_t *msg) { tNcApiWesSetupRequest m; NcApiGetMsgAsWesSetupRequest(msg, &m); NeoMesh::wes_setup_request_callback_(n, &m); }
 };
 
 /*******************************************************************************/
@@ -0,0 +1,25 @@
+// Minimal stand-in for the Arduino core, so the library can be compiled and tested on a PC
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+#include "Stream.h"
+#include "HardwareSerial.h"
+
+#define INPUT_PULLUP 2
+#define FALLING 2
+#define LOW 0
+#define HIGH 1
+
+extern uint32_t g_millis;   // Defined by the test. Advanced by the test to let time pass
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void attachInterrupt(uint8_t, void (*)(void), int) {}
+inline void detachInterrupt(uint8_t) {}
+inline uint32_t millis() { return g_millis; }
+inline uint32_t micros() { return g_millis * 1000; }
+inline void delay(uint32_t ms) { g_millis += ms; }
+inline void noInterrupts() {}
+inline void interrupts() {}
@@ -0,0 +1,10 @@
+// Minimal stand-in for the Arduino HardwareSerial class
+#pragma once
+#include "Stream.h"
+
+class HardwareSerial : public Stream
+{
+public:
+    virtual void begin(unsigned long baud) { (void)baud; }
+    virtual void end() {}
+};
@@ -0,0 +1,35 @@
+// Serial port that keeps what the library writes, and returns bytes queued by the test
+#pragma once
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+
+class MockSerial : public HardwareSerial
+{
+public:
+    std::vector<std::vector<uint8_t>> writes;   // One entry per write call
+    std::deque<uint8_t> rx;
+    int room = 1000;                            // Returned by availableForWrite
+
+    size_t write(uint8_t b) override { this->writes.push_back({b}); return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        this->writes.push_back(std::vector<uint8_t>(buffer, buffer + size));
+        return size;
+    }
+    int availableForWrite() override { return this->room; }
+    int available() override { return this->rx.size(); }
+    int read() override
+    {
+        if (this->rx.empty())
+            return -1;
+        int c = this->rx.front();
+        this->rx.pop_front();
+        return c;
+    }
+    int peek() override { return this->rx.empty() ? -1 : this->rx.front(); }
+    void inject(const std::vector<uint8_t> &bytes) { this->rx.insert(this->rx.end(), bytes.begin(), bytes.end()); }
+};
+
+#define CHECK(condition) \
+    do { if (!(condition)) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); return 1; } } while (0)
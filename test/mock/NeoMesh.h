@@ -0,0 +1,3 @@
+// The library includes its header as NeoMesh.h. This lets it be found on case sensitive file systems
+#pragma once
+#include "../../src/neomesh.h"
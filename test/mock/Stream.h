@@ -0,0 +1,26 @@
+// Minimal stand-in for the Arduino Print and Stream classes
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+class Print
+{
+public:
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+            write(buffer[i]);
+        return size;
+    }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
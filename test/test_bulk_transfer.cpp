@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * @file test_bulk_transfer.cpp
+ * @brief Moves a multi-fragment buffer through BulkTransfer and checks what arrives
+ ******************************************************************************/
+
+// Build and run from the repository root:
+//     g++ -std=gnu++11 -I test/mock -I src src/*.cpp test/test_bulk_transfer.cpp -o test_bulk_transfer && ./test_bulk_transfer
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "MockSerial.h"
+#include "NeoMesh.h"
+#include "BulkTransfer.h"
+
+uint32_t g_millis = 0;
+
+static int sent_result = -1;
+static int received_length = -1;
+
+static void on_sent(tNcBulkResult result) { sent_result = result; }
+static void on_received(uint16_t originId, uint8_t *data, uint16_t length) { (void)originId; (void)data; received_length = length; }
+
+int main()
+{
+    MockSerial serial;
+    NeoMesh neo(&serial, 2);
+    neo.start();
+
+    static uint8_t rx_buffer[3000];
+    BulkTransfer sender(&neo);
+    sender.sent_callback = on_sent;
+    BulkTransfer receiver(&neo);    // Not attached, so frames received by neo go to the sender
+    receiver.set_receive_buffer(rx_buffer, sizeof(rx_buffer));
+    receiver.received_callback = on_received;
+    CHECK(!neo.attach_bulk_transfer(&receiver));
+    CHECK(!receiver.send(20, rx_buffer, 10));
+
+    const uint16_t length = 2000;
+    static uint8_t data[length];
+    srand(1);
+    for (int i = 0; i < length; i++)
+        data[i] = rand();
+    CHECK(length > 2 * NEOMESH_BULK_FRAGMENT_SIZE);
+    CHECK(sender.send(20, data, length));
+
+    // Frames written to the UART are taken apart as the module would, and given to the other side.
+    // Open and data frames go to the receiver, status and done frames come back as received host data
+    for (int step = 0; step < 5000 && sent_result < 0; step++)
+    {
+        NeoMesh::pass_through_cts();
+        neo.update();
+        g_millis += 10;
+
+        while (!serial.writes.empty())
+        {
+            std::vector<uint8_t> w = serial.writes.front();
+            serial.writes.erase(serial.writes.begin());
+            if (w[0] != CommandUnacknowledgedEnum)
+                continue;
+
+            CHECK(w.size() <= NCAPI_TXBUFFER_SIZE);
+            CHECK(w.size() == 2u + w[1]);
+            uint8_t *payload = &w[NEOMESH_UNACK_HEADER_LENGTH];
+            uint8_t payload_length = w.size() - NEOMESH_UNACK_HEADER_LENGTH;
+            if (rand() % 5 == 0)
+                continue;   // 20% of frames are lost
+
+            if (payload[0] == BulkOpen || payload[0] == BulkData)
+            {
+                receiver.frame_received(1, payload, payload_length);
+            }
+            else
+            {
+                std::vector<uint8_t> m = {HostUappDataEnum, (uint8_t)(7 + payload_length), 0, 20, 0, 0, NEOMESH_BULK_PORT, 0, 0};
+                m.insert(m.end(), payload, payload + payload_length);
+                serial.inject(m);
+            }
+        }
+    }
+
+    CHECK(sent_result == BULK_OK);
+    CHECK(received_length == length);
+    CHECK(BulkTransfer::crc16(rx_buffer, received_length) == BulkTransfer::crc16(data, length));
+    CHECK(memcmp(rx_buffer, data, length) == 0);
+    CHECK(neo.get_uapp_stats().sent == 0);   // Bulk frames are not tracked
+    CHECK(neo.get_uapp_stats().evicted == 0);
+    printf("test_bulk_transfer: OK\n");
+    return 0;
+}
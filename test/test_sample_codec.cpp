@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * @file test_sample_codec.cpp
+ * @brief Packs sample series with SampleCodec and checks the mode, width and what decodes
+ ******************************************************************************/
+
+// Build and run from the repository root:
+//     g++ -std=gnu++11 -I test/mock -I src src/*.cpp test/test_sample_codec.cpp -o test_sample_codec && ./test_sample_codec
+
+#include <stdio.h>
+#include "MockSerial.h"
+#include "NeoMesh.h"
+#include "SampleCodec.h"
+
+uint32_t g_millis = 0;
+
+#define PAYLOAD_SIZE NEOMESH_MAX_UNACK_PAYLOAD_LENGTH
+
+static uint8_t mode_of(const uint8_t * payload) { return payload[0] >> 6; }
+static uint8_t width_of(const uint8_t * payload) { return payload[0] & 0x3f; }
+
+// True if the payload decodes to the first used samples
+static bool decodes_to(const uint8_t * payload, uint8_t length, const int32_t * samples, uint16_t used)
+{
+    int32_t decoded[NEOMESH_CODEC_MAX_SAMPLES];
+    if (SampleCodec::decode(payload, length, decoded, NEOMESH_CODEC_MAX_SAMPLES) != used)
+        return false;
+    return memcmp(decoded, samples, used * sizeof(int32_t)) == 0;
+}
+
+int main()
+{
+    uint8_t out[PAYLOAD_SIZE];
+    uint16_t used;
+    uint8_t length;
+
+    // All samples equal. Every difference is 0, so bit packing needs no bits past the first sample
+    static int32_t equal[200];
+    for (int i = 0; i < 200; i++)
+        equal[i] = 1234;
+    length = SampleCodec::encode(equal, 200, out, PAYLOAD_SIZE, &used);
+    CHECK(used == 200);
+    CHECK(mode_of(out) == CodecBitPack);
+    CHECK(width_of(out) == 0);
+    CHECK(length == NEOMESH_CODEC_HEADER_SIZE + 2);     // zig-zag 2468 takes two varint bytes
+    CHECK(decodes_to(out, length, equal, used));
+
+    // Differences of INT32_MIN take all 32 bits. Four bytes each packed, against five as varints
+    int32_t extreme[] = {0, INT32_MIN, 0, INT32_MIN, 0, INT32_MIN};
+    length = SampleCodec::encode(extreme, 6, out, PAYLOAD_SIZE, &used);
+    CHECK(used == 6);
+    CHECK(mode_of(out) == CodecBitPack);
+    CHECK(width_of(out) == 32);
+    CHECK(decodes_to(out, length, extreme, used));
+
+    // Differences between INT32_MIN and INT32_MAX wrap modulo 2^32 and still decode exactly
+    int32_t wrapping[] = {INT32_MAX, INT32_MIN, INT32_MAX, 0, INT32_MIN, -1, INT32_MAX};
+    for (uint16_t i = 0; i < 7; i += used)
+    {
+        length = SampleCodec::encode(wrapping + i, 7 - i, out, PAYLOAD_SIZE, &used);
+        CHECK(used != 0);
+        CHECK(decodes_to(out, length, wrapping + i, used));
+    }
+
+    // Steps of 1 take two bits packed. With 10 bytes, 3 go to the header and first sample,
+    // and the other 7 bytes fit 28 differences. Varints would fit only 7
+    static int32_t ramp[100];
+    for (int i = 0; i < 100; i++)
+        ramp[i] = i;
+    length = SampleCodec::encode(ramp, 100, out, 10, &used);
+    CHECK(used == 29);
+    CHECK(length == 10);
+    CHECK(mode_of(out) == CodecBitPack);
+    CHECK(decodes_to(out, length, ramp, used));
+
+    // The rest follows in further payloads, each no longer than out_size
+    uint16_t offset = 0;
+    while (offset < 100)
+    {
+        length = SampleCodec::encode(ramp + offset, 100 - offset, out, 10, &used);
+        CHECK(used != 0 && length <= 10);
+        CHECK(decodes_to(out, length, ramp + offset, used));
+        offset += used;
+    }
+    CHECK(offset == 100);
+
+    // A first sample that does not fit packs nothing
+    length = SampleCodec::encode(extreme + 1, 1, out, NEOMESH_CODEC_HEADER_SIZE + 4, &used);
+    CHECK(length == 0);
+    CHECK(used == 0);
+
+    // Mostly equal samples with one jump. As varints the jump costs three bytes, while
+    // bit packing would give every difference its 18 bits. Varints fit the whole series
+    int32_t jump[20] = {};
+    for (int i = 10; i < 20; i++)
+        jump[i] = 100000;
+    length = SampleCodec::encode(jump, 20, out, PAYLOAD_SIZE, &used);
+    CHECK(used == 20);
+    CHECK(mode_of(out) == CodecVarint);
+    CHECK(decodes_to(out, length, jump, used));
+
+    // Steady noise of +-1. Varints take a byte per difference, bit packing two bits
+    static int32_t noise[100];
+    for (int i = 0; i < 100; i++)
+        noise[i] = 5000 + (i & 1);
+    length = SampleCodec::encode(noise, 100, out, PAYLOAD_SIZE, &used);
+    CHECK(used > PAYLOAD_SIZE);
+    CHECK(mode_of(out) == CodecBitPack);
+    CHECK(width_of(out) == 2);
+    CHECK(decodes_to(out, length, noise, used));
+
+    printf("test_sample_codec: OK\n");
+    return 0;
+}
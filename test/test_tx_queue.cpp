@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * @file test_tx_queue.cpp
+ * @brief Checks the order in which TxQueue lets frames go, its rate limits and deadlines
+ ******************************************************************************/
+
+// Build and run from the repository root:
+//     g++ -std=gnu++11 -I test/mock -I src src/*.cpp test/test_tx_queue.cpp -o test_tx_queue && ./test_tx_queue
+
+#include <stdio.h>
+#include "MockSerial.h"
+#include "NeoMesh.h"
+#include "TxQueue.h"
+
+uint32_t g_millis = 0;
+
+static tNcTxFrame data_frame(uint16_t dest, uint8_t priority, uint8_t length = NCAPI_TXBUFFER_SIZE)
+{
+    tNcTxFrame frame = {};
+    frame.type = CommandUnacknowledgedEnum;
+    frame.priority = priority;
+    frame.dest = dest;
+    frame.length = length;
+    return frame;
+}
+
+// Destination of the frame sent next, or 0 if none may be sent
+static uint16_t send_next(TxQueue * queue)
+{
+    tNcTxFrame * frame = queue->peek();
+    if (frame == nullptr)
+        return 0;
+    uint16_t dest = frame->dest;
+    queue->pop(frame);
+    return dest;
+}
+
+int main()
+{
+    // Priority burst. The bulk frame waits for NEOMESH_PRIORITY_BURST normal frames, then has its turn
+    {
+        TxQueue queue;
+        tNcTxFrame bulk = data_frame(20, NEOMESH_PRIORITY_BULK);
+        CHECK(queue.push(&bulk));
+        for (int i = 0; i < NEOMESH_PRIORITY_BURST + 2; i++)
+        {
+            tNcTxFrame normal = data_frame(10, NEOMESH_PRIORITY_NORMAL);
+            CHECK(queue.push(&normal));
+        }
+        for (int i = 0; i < NEOMESH_PRIORITY_BURST; i++)
+            CHECK(send_next(&queue) == 10);
+        CHECK(send_next(&queue) == 20);
+        CHECK(send_next(&queue) == 10);
+        CHECK(send_next(&queue) == 10);
+        CHECK(queue.count() == 0);
+    }
+
+    // Deficit round robin. A destination that queued first does not hold back one that queued later
+    {
+        TxQueue queue;
+        for (int i = 0; i < 5; i++)
+        {
+            tNcTxFrame busy = data_frame(10, NEOMESH_PRIORITY_NORMAL);
+            CHECK(queue.push(&busy));
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            tNcTxFrame other = data_frame(11, NEOMESH_PRIORITY_NORMAL);
+            CHECK(queue.push(&other));
+        }
+        const uint16_t expected[] = {10, 11, 10, 11, 10, 10, 10};
+        for (int i = 0; i < 7; i++)
+            CHECK(send_next(&queue) == expected[i]);
+    }
+
+    // Token bucket. One frame a second with a burst of one
+    {
+        TxQueue queue;
+        g_millis = 1000;
+        CHECK(queue.set_rate_limit(10, 60, 1));
+        for (int i = 0; i < 2; i++)
+        {
+            tNcTxFrame limited = data_frame(10, NEOMESH_PRIORITY_NORMAL);
+            CHECK(queue.push(&limited));
+        }
+        CHECK(send_next(&queue) == 10);
+        CHECK(send_next(&queue) == 0);
+        CHECK(queue.time_to_send(millis()) == 1000);
+        g_millis += 1000;
+        CHECK(send_next(&queue) == 10);
+    }
+
+    // Removing a limit from a destination without one takes no flow entry, even if the table is full
+    {
+        TxQueue queue;
+        for (int i = 1; i <= NEOMESH_MAX_FLOWS; i++)
+            CHECK(queue.set_rate_limit(i, 60, 1));
+        CHECK(!queue.set_rate_limit(100, 60, 1));
+        CHECK(queue.set_rate_limit(100, 0, 0));
+        CHECK(queue.set_rate_limit(1, 0, 0));
+        CHECK(queue.get_rate_limit(1) == 0);
+        CHECK(queue.set_rate_limit(100, 60, 1));
+    }
+
+    // Deadlines. A frame is only reported as expired once its deadline has passed
+    {
+        TxQueue queue;
+        g_millis = 5000;
+        tNcTxFrame stale = data_frame(10, NEOMESH_PRIORITY_NORMAL);
+        stale.has_deadline = true;
+        stale.deadline = 5100;
+        tNcTxFrame fresh = data_frame(11, NEOMESH_PRIORITY_NORMAL);
+        CHECK(queue.push(&stale));
+        CHECK(queue.push(&fresh));
+        CHECK(queue.time_to_expiry(5000) == 100);
+        CHECK(queue.next_expired(5099) == nullptr);
+        tNcTxFrame * expired = queue.next_expired(5100);
+        CHECK(expired != nullptr && expired->dest == 10);
+        queue.remove(expired);
+        CHECK(queue.count() == 1);
+        CHECK(queue.time_to_expiry(5100) == NEOMESH_NO_DEADLINE);
+        CHECK(send_next(&queue) == 11);
+    }
+
+    printf("test_tx_queue: OK\n");
+    return 0;
+}